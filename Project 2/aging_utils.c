@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "aging_utils.h"
+#include "arena_utils.h"
+
+// Create empty aging queues for handles in [0, capacity)
+AgingQueues* createAgingQueues(int capacity) {
+    AgingQueues* queues = (AgingQueues*)runAlloc(sizeof(AgingQueues));
+    queues->next = (int*)runAlloc(capacity * sizeof(int));
+    queues->prev = (int*)runAlloc(capacity * sizeof(int));
+    queues->level = (int*)runAlloc(capacity * sizeof(int));
+    queues->order = (int*)runAlloc(capacity * sizeof(int));
+    queues->waitingSince = (int*)runAlloc(capacity * sizeof(int));
+    // A handle joins a level at most once per aging step, and stays due for AGING_THRESHOLD steps
+    queues->dueCapacity = AGING_THRESHOLD * capacity + 1;
+    queues->dueHandle = (int*)runAlloc(queues->dueCapacity * sizeof(int));
+    queues->dueStep = (int*)runAlloc(queues->dueCapacity * sizeof(int));
+    queues->promotions = (Promotion*)runAlloc(capacity * sizeof(Promotion));
+    for (int i = 0; i < capacity; i++) {
+        queues->level[i] = -1;
+    }
+    for (int l = 0; l < AGING_LEVELS; l++) {
+        queues->head[l] = -1;
+        queues->tail[l] = -1;
+    }
+    queues->queued = 0;
+    queues->nextOrder = 0;
+    queues->step = 0;
+    queues->dueFront = 0;
+    queues->dueCount = 0;
+    return queues;
+}
+
+// Check if no handle is waiting in any level
+int isAgingQueuesEmpty(AgingQueues* queues) {
+    return queues->queued == 0;
+}
+
+// Highest (lowest-numbered) level with a waiting handle, or -1 if all are empty
+int highestWaitingLevel(AgingQueues* queues) {
+    for (int l = 0; l < AGING_LEVELS; l++) {
+        if (queues->head[l] != -1) {
+            return l;
+        }
+    }
+    return -1;
+}
+
+// Add a handle to the back of a level
+static void appendHandle(AgingQueues* queues, int handle, int level) {
+    queues->prev[handle] = queues->tail[level];
+    queues->next[handle] = -1;
+    if (queues->tail[level] != -1) {
+        queues->next[queues->tail[level]] = handle;
+    } else {
+        queues->head[level] = handle;
+    }
+    queues->tail[level] = handle;
+    queues->level[handle] = level;
+    queues->order[handle] = queues->nextOrder++;
+    queues->queued++;
+}
+
+// Take a handle out of its level, wherever it is
+static void unlinkHandle(AgingQueues* queues, int handle) {
+    int level = queues->level[handle];
+    if (queues->prev[handle] != -1) {
+        queues->next[queues->prev[handle]] = queues->next[handle];
+    } else {
+        queues->head[level] = queues->next[handle];
+    }
+    if (queues->next[handle] != -1) {
+        queues->prev[queues->next[handle]] = queues->prev[handle];
+    } else {
+        queues->tail[level] = queues->prev[handle];
+    }
+    queues->level[handle] = -1;
+    queues->queued--;
+}
+
+// Log the step at which a handle will have waited AGING_THRESHOLD steps in its level. The top level
+// is never left, so nothing is logged for it.
+static void logDue(AgingQueues* queues, int handle) {
+    if (queues->level[handle] == 0) {
+        return;
+    }
+    if (queues->dueCount == queues->dueCapacity) {
+        fprintf(stderr, "Aging log is full!\n");
+        exit(EXIT_FAILURE);
+    }
+    int slot = (queues->dueFront + queues->dueCount) % queues->dueCapacity;
+    queues->dueHandle[slot] = handle;
+    queues->dueStep[slot] = queues->waitingSince[handle] + AGING_THRESHOLD;
+    queues->dueCount++;
+}
+
+// Add a handle that starts waiting (a new arrival, or a process back from I/O) to the back of a level
+void enqueueWaiting(AgingQueues* queues, int handle, int level) {
+    queues->waitingSince[handle] = queues->step;
+    appendHandle(queues, handle, level);
+    logDue(queues, handle);
+}
+
+// Put a handle that was just dequeued back at the back of its level, still waiting since the same step
+void requeueWaiting(AgingQueues* queues, int handle, int level) {
+    appendHandle(queues, handle, level);
+}
+
+// Remove and return the handle at the front of a level, or -1 if it is empty
+int dequeueLevel(AgingQueues* queues, int level) {
+    int handle = queues->head[level];
+    if (handle != -1) {
+        unlinkHandle(queues, handle);
+    }
+    return handle;
+}
+
+// Order promotions by the level they leave, then by their place in it
+static int comparePromotions(const void* a, const void* b) {
+    const Promotion* x = (const Promotion*)a;
+    const Promotion* y = (const Promotion*)b;
+    if (x->level != y->level) {
+        return x->level - y->level;
+    }
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+// One aging step: every waiting handle has waited one step longer, and those that have now waited
+// AGING_THRESHOLD steps in a level move to the back of the level above, where they start waiting anew.
+// Levels are promoted from the top down and each in queue order, so a handle moves up at most once.
+void ageWaiting(AgingQueues* queues) {
+    queues->step++;
+    int count = 0;
+    while (queues->dueCount > 0 && queues->dueStep[queues->dueFront] <= queues->step) {
+        int handle = queues->dueHandle[queues->dueFront];
+        int due = queues->dueStep[queues->dueFront];
+        queues->dueFront = (queues->dueFront + 1) % queues->dueCapacity;
+        queues->dueCount--;
+        // Skip entries of handles that left their level (or left and came back) since they were logged
+        if (queues->level[handle] > 0 && queues->waitingSince[handle] + AGING_THRESHOLD == due) {
+            queues->promotions[count].level = queues->level[handle];
+            queues->promotions[count].order = queues->order[handle];
+            queues->promotions[count].handle = handle;
+            queues->waitingSince[handle] = queues->step; // A repeated entry must not promote it twice
+            count++;
+        }
+    }
+    if (count > 1) {
+        qsort(queues->promotions, count, sizeof(Promotion), comparePromotions);
+    }
+    for (int i = 0; i < count; i++) {
+        int handle = queues->promotions[i].handle;
+        unlinkHandle(queues, handle);
+        enqueueWaiting(queues, handle, queues->promotions[i].level - 1);
+    }
+}
+
+// A handle that runs alone for several steps is requeued and aged after each of them: it moves up a
+// level every AGING_THRESHOLD steps it spends waiting. Apply all of that at once and queue it in the
+// level it ends up in, which is returned. Nothing else may be waiting.
+int ageLoneHandle(AgingQueues* queues, int handle, int level, int steps) {
+    int waiting = queues->step - queues->waitingSince[handle];
+    queues->step += steps;
+    while (steps > 0 && level > 0) {
+        int untilBump = (waiting < AGING_THRESHOLD) ? AGING_THRESHOLD - waiting : 1;
+        if (steps < untilBump) {
+            break;
+        }
+        steps -= untilBump;
+        level--;
+        waiting = 0;
+    }
+    waiting += steps;
+    // Every logged entry belongs to a handle that is no longer waiting
+    queues->dueCount = 0;
+    queues->waitingSince[handle] = queues->step - waiting;
+    appendHandle(queues, handle, level);
+    logDue(queues, handle);
+    return level;
+}
+
+// Free aging queue memory
+void freeAgingQueues(AgingQueues* queues) {
+    runFree(queues->next);
+    runFree(queues->prev);
+    runFree(queues->level);
+    runFree(queues->order);
+    runFree(queues->waitingSince);
+    runFree(queues->dueHandle);
+    runFree(queues->dueStep);
+    runFree(queues->promotions);
+    runFree(queues);
+}
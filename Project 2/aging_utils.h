@@ -0,0 +1,49 @@
+#ifndef AGING_UTILS_H
+#define AGING_UTILS_H
+
+#define AGING_LEVELS 4    // Priority levels of the HPF queues; level 0 is the highest
+#define AGING_THRESHOLD 5 // Aging steps a process waits in a level before it moves up one
+
+// Process waiting to be promoted in the current aging step
+typedef struct Promotion {
+    int level;  // Level it is leaving
+    int order;  // Its place in that level
+    int handle;
+} Promotion;
+
+// Priority queues of the HPF algorithms with aging. Each level is a FIFO of process handles kept as a
+// doubly linked list, so a handle can leave from any position in O(1). Waiting time is not counted step
+// by step: a handle remembers the aging step from which it has waited in its level, and a log of the
+// steps at which handles become due, kept in the order they were made, yields the handles to promote
+// at each step. An aging step costs O(promotions) instead of O(handles queued).
+typedef struct AgingQueues {
+    int* next;             // next[handle] = handle behind it in its level, or -1
+    int* prev;             // prev[handle] = handle ahead of it in its level, or -1
+    int* level;            // level[handle] = level it is queued in, or -1
+    int* order;            // order[handle] = when it joined the back of its level, so ascending front to back
+    int* waitingSince;     // waitingSince[handle] = aging step from which it has waited in its level
+    int head[AGING_LEVELS]; // First handle of each level, or -1
+    int tail[AGING_LEVELS]; // Last handle of each level, or -1
+    int queued;            // Handles in all levels
+    int nextOrder;         // Order given to the next handle to join a level
+    int step;              // Aging steps so far
+    int* dueHandle;        // Ring of (handle, due step) entries in order of due step; entries of
+    int* dueStep;          // handles that have since left their level are skipped when they come up
+    int dueFront;          // Oldest entry
+    int dueCount;          // Entries in the ring
+    int dueCapacity;       // Room in the ring
+    Promotion* promotions; // Scratch space for the promotions of one step
+} AgingQueues;
+
+// Aging queue utilities
+AgingQueues* createAgingQueues(int capacity);
+int isAgingQueuesEmpty(AgingQueues* queues);
+int highestWaitingLevel(AgingQueues* queues);
+void enqueueWaiting(AgingQueues* queues, int handle, int level);
+void requeueWaiting(AgingQueues* queues, int handle, int level);
+int dequeueLevel(AgingQueues* queues, int level);
+void ageWaiting(AgingQueues* queues);
+int ageLoneHandle(AgingQueues* queues, int handle, int level, int steps);
+void freeAgingQueues(AgingQueues* queues);
+
+#endif
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena_utils.h"
+
+// Bytes of a block header, rounded up so the data is aligned
+#define ARENA_HEADER ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT)
+
+// Arena of the calling thread's current run
+static _Thread_local Arena runArena;
+static _Thread_local int runArenaOpen = 0;
+
+// Round a size up to the alignment; an empty allocation still gets its own address
+static size_t alignSize(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    return (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+}
+
+// Chain a new block of at least size bytes in front of the current one
+static void addBlock(Arena* arena, size_t size) {
+    // Each block is at least as large as all earlier ones, so a run needs few blocks
+    if (size < ARENA_MIN_BLOCK) {
+        size = ARENA_MIN_BLOCK;
+    }
+    if (size < arena->total) {
+        size = arena->total;
+    }
+    ArenaBlock* block = (ArenaBlock*)malloc(ARENA_HEADER + size);
+    if (block == NULL) {
+        fprintf(stderr, "Error allocating a %zu byte arena block!\n", size);
+        exit(EXIT_FAILURE);
+    }
+    block->next = arena->current;
+    block->size = size;
+    block->used = 0;
+    arena->current = block;
+    arena->total += size;
+}
+
+// Allocate size bytes, aligned to ARENA_ALIGNMENT
+void* arenaAlloc(Arena* arena, size_t size) {
+    size = alignSize(size);
+    if (arena->current == NULL || arena->current->size - arena->current->used < size) {
+        addBlock(arena, size);
+    }
+    ArenaBlock* block = arena->current;
+    void* ptr = (char*)block + ARENA_HEADER + block->used;
+    block->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+// Resize an allocation, keeping its first oldSize bytes. The most recent allocation grows in place
+// while its block has room; anything else is copied to a new allocation.
+void* arenaGrow(Arena* arena, void* ptr, size_t oldSize, size_t newSize) {
+    if (ptr == NULL) {
+        return arenaAlloc(arena, newSize);
+    }
+    if (ptr == arena->last) {
+        ArenaBlock* block = arena->current;
+        size_t offset = (size_t)((char*)ptr - ((char*)block + ARENA_HEADER));
+        if (block->size - offset >= alignSize(newSize)) {
+            block->used = offset + alignSize(newSize);
+            return ptr;
+        }
+    }
+    void* moved = arenaAlloc(arena, newSize);
+    memcpy(moved, ptr, (oldSize < newSize) ? oldSize : newSize);
+    return moved;
+}
+
+// Release every allocation at once. With a single block this only rewinds it; if the work needed more,
+// the blocks are replaced by one block of their combined size, so the same work fits next time.
+void resetArena(Arena* arena) {
+    if (arena->current != NULL && arena->current->next != NULL) {
+        size_t total = arena->total;
+        freeArena(arena);
+        addBlock(arena, total);
+    } else if (arena->current != NULL) {
+        arena->current->used = 0;
+    }
+    arena->last = NULL;
+}
+
+// Free arena memory
+void freeArena(Arena* arena) {
+    while (arena->current != NULL) {
+        ArenaBlock* next = arena->current->next;
+        free(arena->current);
+        arena->current = next;
+    }
+    arena->total = 0;
+    arena->last = NULL;
+}
+
+// Start a run on the calling thread: run allocations come from its arena until closeRunArena()
+void openRunArena(void) {
+    if (runArenaOpen) {
+        fprintf(stderr, "The run arena is already open!\n");
+        exit(EXIT_FAILURE);
+    }
+#ifndef NO_RUN_ARENA
+    runArenaOpen = 1;
+#endif
+}
+
+// End the run on the calling thread, releasing everything it allocated
+void closeRunArena(void) {
+    if (runArenaOpen) {
+        resetArena(&runArena);
+        runArenaOpen = 0;
+    }
+}
+
+// Allocate run state
+void* runAlloc(size_t size) {
+    return runArenaOpen ? arenaAlloc(&runArena, size) : malloc(size);
+}
+
+// Allocate zeroed run state
+void* runCalloc(size_t count, size_t size) {
+    if (!runArenaOpen) {
+        return calloc(count, size);
+    }
+    void* ptr = arenaAlloc(&runArena, count * size);
+    memset(ptr, 0, count * size);
+    return ptr;
+}
+
+// Resize run state of oldSize bytes
+void* runRealloc(void* ptr, size_t oldSize, size_t newSize) {
+    return runArenaOpen ? arenaGrow(&runArena, ptr, oldSize, newSize) : realloc(ptr, newSize);
+}
+
+// Free run state; inside a run this waits until closeRunArena()
+void runFree(void* ptr) {
+    if (!runArenaOpen) {
+        free(ptr);
+    }
+}
+
+// Free the calling thread's run arena, e.g. before the thread exits
+void freeRunArena(void) {
+    freeArena(&runArena);
+}
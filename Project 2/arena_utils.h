@@ -0,0 +1,43 @@
+#ifndef ARENA_UTILS_H
+#define ARENA_UTILS_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 16          // Every allocation starts on a multiple of this many bytes
+#define ARENA_MIN_BLOCK (64 * 1024) // Smallest block an arena asks malloc for
+
+// Block of memory an arena hands out front to back; the data follows the header
+typedef struct ArenaBlock {
+    struct ArenaBlock* next; // Block that filled up before this one, or NULL
+    size_t size;             // Bytes of data
+    size_t used;             // Bytes handed out
+} ArenaBlock;
+
+// Bump allocator. Allocations are carved off the current block, and once it is full a larger block is
+// chained in front of it. Nothing is freed on its own: a reset releases everything at once and keeps a
+// single block as large as all of them, so running the same work again never calls malloc.
+typedef struct Arena {
+    ArenaBlock* current; // Block allocations come from, or NULL before the first one
+    size_t total;        // Bytes of data in all blocks
+    void* last;          // Most recent allocation, which can grow in place, or NULL
+} Arena;
+
+// Arena utilities
+void* arenaAlloc(Arena* arena, size_t size);
+void* arenaGrow(Arena* arena, void* ptr, size_t oldSize, size_t newSize);
+void resetArena(Arena* arena);
+void freeArena(Arena* arena);
+
+// Per-thread arena holding the state of one run. Between openRunArena() and closeRunArena() the run
+// functions allocate from it and runFree() does nothing; closing resets it, so the next run on the
+// thread reuses the same memory. Outside a run they fall back to malloc and free. Compile with
+// -DNO_RUN_ARENA to always use malloc, e.g. so AddressSanitizer sees every allocation.
+void openRunArena(void);
+void closeRunArena(void);
+void* runAlloc(size_t size);
+void* runCalloc(size_t count, size_t size);
+void* runRealloc(void* ptr, size_t oldSize, size_t newSize);
+void runFree(void* ptr);
+void freeRunArena(void);
+
+#endif
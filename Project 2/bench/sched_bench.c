@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../process_utils.h"
+#include "../simulation.h"
+#include "../runner.h"
+#include "../rng_utils.h"
+#include "../queue_utils.h"
+#include "../select_utils.h"
+#include "../arena_utils.h"
+
+#define BENCH_MIN_N 10          // Smallest workload
+#define BENCH_MAX_N 1000000     // Largest workload (--max-n)
+#define BENCH_REPS 5            // Timed runs per workload size (--reps)
+#define BENCH_WARMUP 1          // Untimed runs before them (--warmup)
+#define BENCH_BUDGET 5.0        // Seconds a timed run may be expected to take; larger sizes are skipped (--budget)
+#define BENCH_LOAD 0.9          // Offered load: CPU time asked for per quantum of the horizon (--load)
+#define BENCH_MEAN_RUNTIME 5.5  // Mean runtime of a generated process
+
+#define KERNEL_MIN_READY 4            // Smallest ready set of --kernels
+#define KERNEL_MAX_READY 65536        // Largest ready set of --kernels
+#define KERNEL_WORK (1 << 24)         // Keys a scan timing visits, so every size takes about as long
+#define KERNEL_MIN_SELECTIONS 10000   // Fewest selections timed per size
+#define KERNEL_MAX_KEY 1000           // Keys are drawn from 1 to this, so ties occur
+
+static const char* selectionNames[] = { "heap", "scan", "auto" }; // Indexed by SELECT_*
+
+// Seconds on the monotonic clock
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compareDoubles(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Time one run of an algorithm on a private copy of the workload. Copying the workload and
+// setting up the result are not timed. The run allocates from the run arena, as in the simulator.
+// Returns the seconds taken and the decisions made.
+static double timeRun(const Scheduler* scheduler, const Process* workload, Process* processes, int numProcesses,
+                      const SimConfig* config, int* decisions)
+{
+    memcpy(processes, workload, numProcesses * sizeof(Process));
+    openRunArena();
+    RunResult run;
+    initRunResult(&run, numProcesses, 0);
+    double start = now();
+    if (config->cpus > 1)
+    {
+        runMulticore(scheduler->policy, processes, numProcesses, config, &run);
+    }
+    else
+    {
+        scheduler->run(processes, numProcesses, config, &run);
+    }
+    double elapsed = now() - start;
+    *decisions = run.decisions;
+    freeRunResult(&run);
+    closeRunArena();
+    return elapsed;
+}
+
+// Median over the repetitions of timeSelections() for one selection strategy
+static double medianSelectionTime(ReadyHeap* heap, const int* keys, int n, int reps, int warmup, double* times)
+{
+    int selections = KERNEL_WORK / n;
+    if (selections < KERNEL_MIN_SELECTIONS)
+    {
+        selections = KERNEL_MIN_SELECTIONS;
+    }
+    for (int r = 0; r < warmup; r++)
+    {
+        timeSelections(heap, keys, n, selections);
+    }
+    for (int r = 0; r < reps; r++)
+    {
+        times[r] = timeSelections(heap, keys, n, selections);
+    }
+    qsort(times, reps, sizeof(double), compareDoubles);
+    return times[reps / 2];
+}
+
+// Compare the ways SJF and SRTF can find the shortest ready process on ready sets of 4 to 65536
+// processes: the binary heap, and the scan layout with the scalar and (if the CPU has it) the AVX2
+// argmin kernel. Prints the cost of a selection and, for each kernel, the largest ready set at which
+// scanning still beats the heap, next to the crossover --select auto measured at startup.
+static void benchKernels(int reps, int warmup, int csv, uint64_t seed, double* times)
+{
+    int avx2 = hasAvx2();
+    int* keys = (int*)malloc(KERNEL_MAX_READY * sizeof(int));
+    ReadyHeap* binary = createReadyHeap(KERNEL_MAX_READY);
+    ReadyHeap* scalar = createScanHeap(KERNEL_MAX_READY);
+    ReadyHeap* vector = createScanHeap(KERNEL_MAX_READY);
+    if (keys == NULL)
+    {
+        fprintf(stderr, "Error allocating benchmark keys!\n");
+        exit(EXIT_FAILURE);
+    }
+    scalar->argmin = argminHandleScalar;
+    vector->argmin = argminHandleAvx2;
+    Rng rng;
+    rngStream(&rng, seed, 0);
+    for (int i = 0; i < KERNEL_MAX_READY; i++)
+    {
+        keys[i] = 1 + rngRange(&rng, KERNEL_MAX_KEY);
+    }
+
+    if (csv)
+    {
+        printf("ready,heap_ns,scalar_ns,avx2_ns\n");
+    }
+    else
+    {
+        printf("Seed %llu, AVX2 %s, median of %d runs after %d warmup run(s)\n\n",
+               (unsigned long long)seed, avx2 ? "supported" : "not supported", reps, warmup);
+        printf("%10s %12s %12s %12s\n", "Ready", "heap ns", "scalar ns", "avx2 ns");
+    }
+    int scalarCrossover = 0; // Largest ready set at which each kernel beat the heap
+    int vectorCrossover = 0;
+    for (int n = KERNEL_MIN_READY; n <= KERNEL_MAX_READY; n *= 2)
+    {
+        double heapTime = medianSelectionTime(binary, keys, n, reps, warmup, times);
+        double scalarTime = medianSelectionTime(scalar, keys, n, reps, warmup, times);
+        double vectorTime = avx2 ? medianSelectionTime(vector, keys, n, reps, warmup, times) : -1;
+        if (scalarTime < heapTime)
+        {
+            scalarCrossover = n;
+        }
+        if (avx2 && vectorTime < heapTime)
+        {
+            vectorCrossover = n;
+        }
+        if (csv)
+        {
+            printf("%d,%.2f,%.2f,%.2f\n", n, heapTime, scalarTime, vectorTime);
+        }
+        else if (avx2)
+        {
+            printf("%10d %12.2f %12.2f %12.2f\n", n, heapTime, scalarTime, vectorTime);
+        }
+        else
+        {
+            printf("%10d %12.2f %12.2f %12s\n", n, heapTime, scalarTime, "-");
+        }
+        fflush(stdout);
+    }
+    if (!csv)
+    {
+        printf("\nThe scalar kernel beats the heap up to %d ready processes.\n", scalarCrossover);
+        if (avx2)
+        {
+            printf("The AVX2 kernel beats the heap up to %d ready processes.\n", vectorCrossover);
+        }
+        printf("--select auto measured that it scans in runs of up to %d processes on this CPU.\n", scanSelectMaxProcesses());
+    }
+
+    free(keys);
+    freeReadyHeap(binary);
+    freeReadyHeap(scalar);
+    freeReadyHeap(vector);
+}
+
+// Microbenchmark of the cost of a scheduling decision: every algorithm runs on generated workloads of
+// 10, 100, ... up to --max-n processes. Each size is run --warmup times untimed and --reps times timed,
+// and the median time is divided by the number of decisions (times a process was picked to run on a
+// CPU). The output is a table, or CSV with --csv, to compare before and after changing the queues.
+// With --kernels it compares the selection strategies of SJF and SRTF instead.
+int main(int argc, char** argv)
+{
+    int maxN = BENCH_MAX_N;
+    int reps = BENCH_REPS;
+    int warmup = BENCH_WARMUP;
+    double budget = BENCH_BUDGET;
+    double load = BENCH_LOAD;
+    int csv = 0;
+    int kernels = 0;
+    const char* only = NULL; // --algorithm: benchmark just this algorithm
+    SimConfig config = defaultSimConfig();
+    config.verbosity = VERBOSITY_QUIET;
+    config.seed = 1;  // Workloads are drawn from seed 1 unless --seed is given
+    config.trial = 1; // Every run is trial 1, so randomized policies draw the same streams each time
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--max-n") == 0 && i + 1 < argc)
+        {
+            maxN = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc)
+        {
+            reps = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+        {
+            warmup = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+        {
+            budget = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+        {
+            load = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--io-mix") == 0 && i + 1 < argc)
+        {
+            config.ioPercent = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc)
+        {
+            config.cpus = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--select") == 0 && i + 1 < argc && strcmp(argv[i + 1], "heap") == 0)
+        {
+            config.selection = SELECT_HEAP;
+            i++;
+        }
+        else if (strcmp(argv[i], "--select") == 0 && i + 1 < argc && strcmp(argv[i + 1], "scan") == 0)
+        {
+            config.selection = SELECT_SCAN;
+            i++;
+        }
+        else if (strcmp(argv[i], "--select") == 0 && i + 1 < argc && strcmp(argv[i + 1], "auto") == 0)
+        {
+            config.selection = SELECT_AUTO;
+            i++;
+        }
+        else if (strcmp(argv[i], "--algorithm") == 0 && i + 1 < argc)
+        {
+            only = argv[++i];
+        }
+        else if (strcmp(argv[i], "--csv") == 0)
+        {
+            csv = 1;
+        }
+        else if (strcmp(argv[i], "--kernels") == 0)
+        {
+            kernels = 1;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--max-n <n>] [--reps <n>] [--warmup <n>] [--budget <seconds>] [--load <x>]\n"
+                            "       [--seed <n>] [--io-mix <percent>] [--cpus <n>] [--select auto|heap|scan]\n"
+                            "       [--algorithm <name>] [--csv] [--kernels]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (maxN < BENCH_MIN_N || reps <= 0 || warmup < 0 || budget <= 0 || load <= 0 || config.cpus <= 0 ||
+        config.ioPercent < 0 || config.ioPercent > 100)
+    {
+        fprintf(stderr, "The largest size must be at least %d, the repetitions, budget, load and CPUs positive, the warmup non-negative\n"
+                        "and the I/O mix between 0 and 100 percent.\n", BENCH_MIN_N);
+        return EXIT_FAILURE;
+    }
+
+    // Let --select auto measure its crossover before anything is timed
+    if (config.selection == SELECT_AUTO || kernels)
+    {
+        scanSelectMaxProcesses();
+    }
+
+    if (kernels)
+    {
+        double* kernelTimes = (double*)malloc(reps * sizeof(double));
+        if (kernelTimes == NULL)
+        {
+            fprintf(stderr, "Error allocating benchmark timings!\n");
+            return EXIT_FAILURE;
+        }
+        benchKernels(reps, warmup, csv, config.seed, kernelTimes);
+        free(kernelTimes);
+        return 0;
+    }
+
+    Process* workload = (Process*)malloc(maxN * sizeof(Process));
+    Process* processes = (Process*)malloc(maxN * sizeof(Process));
+    double* times = (double*)malloc(reps * sizeof(double));
+    int* skipped = (int*)calloc(numSchedulers, sizeof(int)); // Algorithms that ran out of budget
+    if (workload == NULL || processes == NULL || times == NULL || skipped == NULL)
+    {
+        fprintf(stderr, "Error allocating benchmark workloads!\n");
+        return EXIT_FAILURE;
+    }
+
+    if (csv)
+    {
+        printf("algorithm,processes,decisions,ns_per_decision,decisions_per_second\n");
+    }
+    else
+    {
+        printf("Seed %llu, load %.2f, %d CPU(s), %s selection, median of %d runs after %d warmup run(s)\n\n",
+               (unsigned long long)config.seed, load, config.cpus, selectionNames[config.selection], reps, warmup);
+        printf("%-20s %10s %12s %14s %16s\n", "Algorithm", "Processes", "Decisions", "ns/decision", "decisions/s");
+    }
+    for (long long n = BENCH_MIN_N; n <= maxN; n *= 10)
+    {
+        // The horizon grows with the workload, so every size offers the CPU the same load
+        int numProcesses = (int)n;
+        config.horizon = (int)(numProcesses * BENCH_MEAN_RUNTIME / load) + 1;
+        Rng rng;
+        rngStream(&rng, config.seed, 0);
+        generateProcesses(workload, numProcesses, config.horizon, config.deadlineFactor, config.ioPercent, &rng);
+
+        for (int s = 0; s < numSchedulers; s++)
+        {
+            const Scheduler* scheduler = &schedulers[s];
+            if (skipped[s] || (only != NULL && strcmp(only, scheduler->name) != 0))
+            {
+                continue;
+            }
+            int decisions = 0;
+            for (int r = 0; r < warmup; r++)
+            {
+                timeRun(scheduler, workload, processes, numProcesses, &config, &decisions);
+            }
+            for (int r = 0; r < reps; r++)
+            {
+                times[r] = timeRun(scheduler, workload, processes, numProcesses, &config, &decisions);
+            }
+            qsort(times, reps, sizeof(double), compareDoubles);
+            double median = times[reps / 2];
+            double perDecision = (decisions > 0) ? median * 1e9 / decisions : 0.0;
+            double perSecond = (median > 0) ? decisions / median : 0.0;
+            if (csv)
+            {
+                printf("%s,%d,%d,%.2f,%.0f\n", scheduler->name, numProcesses, decisions, perDecision, perSecond);
+            }
+            else
+            {
+                printf("%-20s %10d %12d %14.2f %16.0f\n", scheduler->name, numProcesses, decisions, perDecision, perSecond);
+            }
+            fflush(stdout);
+            // The next size has ten times the processes, so it takes at least ten times as long
+            if (median * 10 > budget && n * 10 <= maxN)
+            {
+                skipped[s] = 1;
+                fprintf(stderr, "%s took %.2f s on %d processes; skipping larger workloads\n", scheduler->name, median, numProcesses);
+            }
+        }
+    }
+
+    free(workload);
+    free(processes);
+    free(times);
+    free(skipped);
+    freeRunArena();
+    return 0;
+}
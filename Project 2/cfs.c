@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "event_utils.h"
+#include "simulation.h"
+#include "arena_utils.h"
+
+#define NICE_0_WEIGHT 1024 // Load weight of a nice 0 process
+
+// Load weight of a priority level. Priorities 1 to 4 run at nice -10, -5, 0 and 5, with the
+// Linux weights for those nice values (every nice step is worth about 10% of CPU time).
+int cfsWeight(int priority)
+{
+    static const int weights[4] = { 9548, 3121, 1024, 335 };
+    return weights[priority - 1];
+}
+
+// Virtual runtime charged for running a number of quanta: real time scaled by nice 0 weight / weight,
+// so heavier (higher priority) processes age more slowly
+long long cfsVruntime(int quanta, int priority)
+{
+    return ((long long)quanta << CFS_VRUNTIME_SHIFT) * NICE_0_WEIGHT / cfsWeight(priority);
+}
+
+// Time slice of a process: its weighted share of the target latency, but at least one quantum
+int cfsTimeSlice(const SimConfig* config, int priority, long long runnableWeight)
+{
+    long long slice = (long long)config->cfsLatency * cfsWeight(priority) / runnableWeight;
+    return (slice > 0) ? (int)slice : 1;
+}
+
+// Completely Fair Scheduler: the runnable process with the smallest virtual runtime runs for its
+// slice of the target latency. Waiting processes are kept in a red-black tree ordered by virtual
+// runtime, and new processes start at the smallest virtual runtime so they cannot hog the CPU. A process
+// waking up from I/O keeps its own virtual runtime unless that has fallen behind the smallest one.
+void cfs(Process processes[], int numProcesses, const SimConfig* config, RunResult* result)
+{
+    RunTree* tree = createRunTree(numProcesses);
+    long long* vruntime = (long long*)runCalloc(numProcesses, sizeof(long long));
+    if (vruntime == NULL)
+    {
+        fprintf(stderr, "Error allocating CFS state!\n");
+        exit(EXIT_FAILURE);
+    }
+    Timeline* t = createTimeline(100);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
+
+    long long minVruntime = 0;    // Never decreases; follows the smallest runnable virtual runtime
+    long long runnableWeight = 0; // Total weight of the running and waiting processes
+    int running = -1, sliceEnd = 0;
+    int currentTime = 0, completed = 0;
+
+    while (completed < numProcesses)
+    {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
+        {
+            result->stoppedAt = config->horizon;
+            break;
+        }
+
+        // New processes start at the smallest virtual runtime, and so do woken ones that are further behind
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
+        {
+            if (vruntime[arrived] < minVruntime)
+            {
+                vruntime[arrived] = minVruntime;
+            }
+            runnableWeight += cfsWeight(processes[arrived].priority);
+            runTreeInsert(tree, arrived, vruntime[arrived]);
+        }
+
+        // The running process yields once a waiting one is more than the wakeup granularity behind it
+        if (running != -1 && !isRunTreeEmpty(tree) && vruntime[running] - vruntime[runTreeMin(tree)] > CFS_WAKEUP_GRANULARITY)
+        {
+            runTreeInsert(tree, running, vruntime[running]);
+            running = -1;
+        }
+
+        if (running == -1)
+        {
+            if (isRunTreeEmpty(tree))
+            {
+                // CPU is idle until the next arrival
+                currentTime = skipIdleTime(&arrivals, t, currentTime, config->horizon);
+                continue;
+            }
+            running = runTreeMin(tree);
+            runTreeRemove(tree, running);
+            result->decisions++;
+            sliceEnd = currentTime + cfsTimeSlice(config, processes[running].priority, runnableWeight);
+        }
+
+        // Run until the slice ends, the process finishes or the next process arrives. A process that
+        // is alone is simply picked again with a new slice, which keeps slice boundaries exact. A context
+        // switch to a newly picked process delays the step and its slice.
+        int runUntil = currentTime + processes[running].remainingTime;
+        if (sliceEnd < runUntil)
+        {
+            runUntil = sliceEnd;
+        }
+        runUntil = nextEventTime(&arrivals, currentTime, runUntil < config->horizon ? runUntil : config->horizon);
+        int step = runUntil - currentTime;
+        int runStart = switchContext(t, currentTime, processes[running].pid, config->switchCost);
+        sliceEnd += runStart - currentTime;
+        currentTime = runStart;
+        if (processes[running].startTime == -1)
+        {
+            processes[running].startTime = currentTime;
+        }
+        updateTimeline(t, currentTime, step, processes[running].pid);
+        processes[running].remainingTime -= step;
+        vruntime[running] += cfsVruntime(step, processes[running].priority);
+        currentTime += step;
+
+        if (processes[running].remainingTime == 0)
+        {
+            // Finished, or blocked until its I/O is done
+            runnableWeight -= cfsWeight(processes[running].priority);
+            if (finishBurst(&arrivals, running, currentTime))
+            {
+                processes[running].completionTime = currentTime;
+                recordCompletion(result, &processes[running]);
+                completed++;
+            }
+            running = -1;
+        }
+        else if (currentTime >= sliceEnd)
+        {
+            // Slice used up: back into the tree at its new virtual runtime
+            runTreeInsert(tree, running, vruntime[running]);
+            running = -1;
+        }
+
+        // Advance the minimum virtual runtime to the smallest of the running and waiting processes
+        long long smallest = (running != -1) ? vruntime[running] : -1;
+        if (!isRunTreeEmpty(tree) && (smallest == -1 || vruntime[runTreeMin(tree)] < smallest))
+        {
+            smallest = vruntime[runTreeMin(tree)];
+        }
+        if (smallest > minVruntime)
+        {
+            minVruntime = smallest;
+        }
+    }
+
+    // Calculate averages for this run; the result takes over the timeline
+    finishRunResult(result, t);
+
+    // Free allocated resources
+    freeRunTree(tree);
+    runFree(vruntime);
+    freeArrivalCursor(&arrivals);
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "event_utils.h"
+#include "simulation.h"
+
+// Earliest Deadline First: the ready process with the earliest deadline runs, and an arriving process with
+// an earlier deadline preempts it. Processes without a deadline only run when no process with one is ready.
+void edf(Process processes[], int numProcesses, const SimConfig* config, RunResult* result)
+{
+    ReadyHeap* ready = createReadyHeap(numProcesses); // Ready processes keyed on deadline
+    Timeline* t = createTimeline(100);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
+    int currentTime = 0, completed = 0;
+
+    while (completed < numProcesses)
+    {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
+        {
+            result->stoppedAt = config->horizon;
+            break;
+        }
+
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
+        {
+            heapInsert(ready, arrived, processes[arrived].deadline);
+        }
+
+        if (isHeapEmpty(ready))
+        {
+            // CPU is idle until the next arrival
+            currentTime = skipIdleTime(&arrivals, t, currentTime, config->horizon);
+            continue;
+        }
+
+        // The top of the heap has the earliest deadline, which only an arrival can beat, so it runs
+        // until the next process arrives or it finishes. A context switch to it delays the whole step.
+        int handle = heapPeek(ready);
+        Process* process = &processes[handle];
+        result->decisions++;
+        int runUntil = currentTime + process->remainingTime;
+        int step = nextEventTime(&arrivals, currentTime, runUntil < config->horizon ? runUntil : config->horizon) - currentTime;
+        currentTime = switchContext(t, currentTime, process->pid, config->switchCost);
+        if (process->startTime == -1)
+        {
+            process->startTime = currentTime;
+        }
+        updateTimeline(t, currentTime, step, process->pid);
+        process->remainingTime -= step;
+        currentTime += step;
+
+        if (process->remainingTime == 0)
+        {
+            // Finished, or blocked until its I/O is done
+            heapRemove(ready, handle);
+            if (finishBurst(&arrivals, handle, currentTime))
+            {
+                process->completionTime = currentTime;
+                recordCompletion(result, process);
+                completed++;
+            }
+        }
+    }
+
+    // Calculate averages for this run; the result takes over the timeline
+    finishRunResult(result, t);
+
+    // Free allocated resources
+    freeReadyHeap(ready);
+    freeArrivalCursor(&arrivals);
+}
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "event_utils.h"
+
+// Initialize a cursor over processes already sorted by arrival time (generateProcesses() sorts them).
+// With a trace, the array only has room for the processes, which are read from the trace as they arrive.
+void initArrivalCursor(ArrivalCursor* cursor, Process* processes, int numProcesses, WorkloadReader* trace) {
+    cursor->processes = processes;
+    cursor->numProcesses = numProcesses;
+    cursor->next = 0;
+    cursor->trace = trace;
+    cursor->loaded = (trace != NULL) ? 0 : numProcesses;
+    cursor->blocked = NULL;
+}
+
+// Check if any process has yet to arrive or is blocked on I/O
+int hasPendingArrivals(ArrivalCursor* cursor) {
+    return cursor->next < cursor->numProcesses || (cursor->blocked != NULL && !isHeapEmpty(cursor->blocked));
+}
+
+// Return the time the next process arrives for the first time, or INT_MAX if they all have. A streamed
+// process is read from the trace here, the first time the cursor looks at it.
+int peekNewArrivalTime(ArrivalCursor* cursor) {
+    if (cursor->next == cursor->numProcesses) {
+        return INT_MAX;
+    }
+    if (cursor->next == cursor->loaded) {
+        if (!readNextProcess(cursor->trace, &cursor->processes[cursor->loaded])) {
+            fprintf(stderr, "%s: trace ended after %d of its %d processes\n", cursor->trace->path, cursor->loaded, cursor->numProcesses);
+            exit(EXIT_FAILURE);
+        }
+        cursor->loaded++;
+    }
+    return cursor->processes[cursor->next].arrivalTime;
+}
+
+// Return the time the next process arrives or finishes its I/O, or INT_MAX if there is none
+int peekArrivalTime(ArrivalCursor* cursor) {
+    int arrival = peekNewArrivalTime(cursor);
+    if (cursor->blocked != NULL && !isHeapEmpty(cursor->blocked)) {
+        int wake = (int)cursor->blocked->key[heapPeek(cursor->blocked)];
+        return (wake < arrival) ? wake : arrival;
+    }
+    return arrival;
+}
+
+// Return the index of the next process that has arrived (or finished its I/O) by currentTime, or -1 if
+// there is none. Callers drain this in a loop, so each arrival is admitted exactly once in O(1); at equal
+// times new processes come before woken ones.
+int nextArrival(ArrivalCursor* cursor, int currentTime) {
+    int arrival = peekNewArrivalTime(cursor);
+    if (cursor->blocked != NULL && !isHeapEmpty(cursor->blocked)) {
+        int woken = heapPeek(cursor->blocked);
+        if (cursor->blocked->key[woken] < arrival && cursor->blocked->key[woken] <= currentTime) {
+            heapRemove(cursor->blocked, woken);
+            return woken;
+        }
+    }
+    if (arrival > currentTime) {
+        return -1;
+    }
+    return cursor->next++;
+}
+
+// Called when a process has run out its current CPU burst at currentTime. Returns 1 if that was its last
+// burst and the process has finished. Otherwise it blocks on its own device for its I/O burst and
+// returns 0; its remaining time is then its next CPU burst, and it arrives again once the I/O is done.
+int finishBurst(ArrivalCursor* cursor, int handle, int currentTime) {
+    Process* process = &cursor->processes[handle];
+    if (process->burst + 1 >= process->cpuBursts) {
+        return 1;
+    }
+    if (cursor->blocked == NULL) {
+        cursor->blocked = createReadyHeap(cursor->numProcesses);
+    }
+    process->burst++;
+    process->remainingTime = cpuBurstLength(process, process->burst);
+    heapInsert(cursor->blocked, handle, (long long)currentTime + process->ioLength);
+    return 0;
+}
+
+// Free the blocked heap of a cursor, if the run ever needed one
+void freeArrivalCursor(ArrivalCursor* cursor) {
+    if (cursor->blocked != NULL) {
+        freeReadyHeap(cursor->blocked);
+        cursor->blocked = NULL;
+    }
+}
+
+// Return the time of the next scheduling event: the earlier of runUntil and the next arrival.
+// All arrivals up to currentTime must already have been admitted.
+int nextEventTime(ArrivalCursor* cursor, int currentTime, int runUntil) {
+    int arrival = peekArrivalTime(cursor);
+    if (arrival <= currentTime) {
+        fprintf(stderr, "Arrival at time %d was not admitted before time %d!\n", arrival, currentTime);
+        exit(EXIT_FAILURE);
+    }
+    return (arrival < runUntil) ? arrival : runUntil;
+}
+
+// Jump the idle CPU straight to the next arrival (capped at the horizon) with a single timeline update
+int skipIdleTime(ArrivalCursor* cursor, Timeline* t, int currentTime, int horizon) {
+    int wakeTime = nextEventTime(cursor, currentTime, horizon);
+    if (wakeTime > currentTime) {
+        updateTimeline(t, currentTime, wakeTime - currentTime, IDLE_PID);
+    }
+    return wakeTime;
+}
+
+// Charge a context switch before a process runs on a CPU that last ran a different process. The CPU spends
+// switchCost quanta switching, recorded on the timeline, and the process's step starts that much later;
+// arrivals during the switch are admitted once the step is over. Returns the time the process starts running.
+int switchContext(Timeline* t, int currentTime, int pid, int switchCost) {
+    if (switchCost == 0 || t->lastPid == IDLE_PID || t->lastPid == pid) {
+        return currentTime;
+    }
+    updateTimeline(t, currentTime, switchCost, SWITCH_PID);
+    return currentTime + switchCost;
+}
@@ -0,0 +1,37 @@
+#ifndef EVENT_UTILS_H
+#define EVENT_UTILS_H
+
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "workload_utils.h"
+
+// Arrival cursor: walks a process array sorted by arrival time exactly once per run. When a run replays
+// a trace, each process is read into its slot only when the cursor reaches it. Processes blocked on I/O
+// wait in a heap keyed on the time their device finishes, and come back through the cursor like new
+// arrivals when it does.
+typedef struct ArrivalCursor {
+    Process* processes; // Processes sorted by arrival time
+    int numProcesses;   // Number of processes in the array
+    int next;           // Index of the first process that has not arrived yet
+    WorkloadReader* trace; // Trace the processes are streamed from, or NULL if they are all in the array
+    int loaded;         // Number of processes in the array so far
+    ReadyHeap* blocked; // Processes blocked on I/O keyed on their wake-up time (created on the first block)
+} ArrivalCursor;
+
+// Arrival cursor utilities
+void initArrivalCursor(ArrivalCursor* cursor, Process* processes, int numProcesses, WorkloadReader* trace);
+int hasPendingArrivals(ArrivalCursor* cursor);
+int peekNewArrivalTime(ArrivalCursor* cursor);
+int peekArrivalTime(ArrivalCursor* cursor);
+int nextArrival(ArrivalCursor* cursor, int currentTime);
+int finishBurst(ArrivalCursor* cursor, int handle, int currentTime);
+void freeArrivalCursor(ArrivalCursor* cursor);
+
+// Next-event time jumps
+int nextEventTime(ArrivalCursor* cursor, int currentTime, int runUntil);
+int skipIdleTime(ArrivalCursor* cursor, Timeline* t, int currentTime, int horizon);
+
+// Context switches
+int switchContext(Timeline* t, int currentTime, int pid, int switchCost);
+
+#endif
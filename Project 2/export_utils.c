@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include "export_utils.h"
+
+// Growable text buffer that a run's records are formatted into before they are written
+typedef struct TextBuffer {
+    char* data;
+    size_t length;
+    size_t capacity;
+} TextBuffer;
+
+// Append formatted text to a buffer, growing it as needed
+static void appendText(TextBuffer* text, const char* format, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(text->data + text->length, text->capacity - text->length, format, args);
+        va_end(args);
+        if (written < 0) {
+            fprintf(stderr, "Error formatting exported record!\n");
+            exit(EXIT_FAILURE);
+        }
+        if ((size_t)written < text->capacity - text->length) {
+            text->length += written;
+            return;
+        }
+        size_t capacity = text->capacity * 2 + written;
+        char* data = (char*)realloc(text->data, capacity);
+        if (data == NULL) {
+            fprintf(stderr, "Error reallocating export buffer!\n");
+            exit(EXIT_FAILURE);
+        }
+        text->data = data;
+        text->capacity = capacity;
+    }
+}
+
+// Open a sink and write the CSV header for its kind of record
+ResultSink* openResultSink(const char* path, int format, int kind) {
+    ResultSink* sink = (ResultSink*)malloc(sizeof(ResultSink));
+    if (sink == NULL) {
+        fprintf(stderr, "Error allocating result sink!\n");
+        exit(EXIT_FAILURE);
+    }
+    sink->file = fopen(path, "w");
+    if (sink->file == NULL) {
+        perror("Failed to open export file");
+        exit(EXIT_FAILURE);
+    }
+    sink->buffer = (char*)malloc(EXPORT_BUFFER_SIZE);
+    if (sink->buffer == NULL || setvbuf(sink->file, sink->buffer, _IOFBF, EXPORT_BUFFER_SIZE) != 0) {
+        fprintf(stderr, "Error setting up the export buffer!\n");
+        exit(EXIT_FAILURE);
+    }
+    sink->format = format;
+    sink->kind = kind;
+    pthread_mutex_init(&sink->lock, NULL);
+
+    if (format == EXPORT_CSV) {
+        if (kind == EXPORT_RUNS) {
+            fprintf(sink->file, "trial,algorithm,completed,total_time,avg_turnaround,avg_waiting,avg_response,throughput,utilization,context_switches,switch_time,deadline_misses,miss_rate,prediction_error\n");
+        } else {
+            fprintf(sink->file, "trial,algorithm,pid,arrival,runtime,io_time,priority,deadline,start,completion,turnaround,waiting,response\n");
+        }
+    }
+    return sink;
+}
+
+// Format the summary record of a run
+static void formatRun(TextBuffer* text, int format, int trial, const char* algorithm, const RunResult* result) {
+    if (format == EXPORT_CSV) {
+        appendText(text, "%d,%s,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d,%d,%.6f,%.6f\n",
+                   trial, algorithm, result->completed, result->totalTime,
+                   result->avgTurnaroundTime, result->avgWaitingTime, result->avgResponseTime,
+                   result->throughput, result->utilization, result->contextSwitches, result->switchTime, result->deadlineMisses, result->missRate,
+                   result->predictionError);
+    } else {
+        appendText(text, "{\"trial\":%d,\"algorithm\":\"%s\",\"completed\":%d,\"total_time\":%d,"
+                   "\"avg_turnaround\":%.6f,\"avg_waiting\":%.6f,\"avg_response\":%.6f,"
+                   "\"throughput\":%.6f,\"utilization\":%.6f,\"context_switches\":%d,\"switch_time\":%d,\"deadline_misses\":%d,\"miss_rate\":%.6f,\"prediction_error\":%.6f}\n",
+                   trial, algorithm, result->completed, result->totalTime,
+                   result->avgTurnaroundTime, result->avgWaitingTime, result->avgResponseTime,
+                   result->throughput, result->utilization, result->contextSwitches, result->switchTime, result->deadlineMisses, result->missRate,
+                   result->predictionError);
+    }
+}
+
+// Format one record per finished process of a run
+static void formatProcesses(TextBuffer* text, int format, int trial, const char* algorithm, const RunResult* result) {
+    for (int i = 0; i < result->completed; i++) {
+        const ProcessRecord* record = &result->records[i];
+        int turnaround = record->completionTime - record->arrivalTime;
+        int waiting = turnaround - record->runtime - record->ioTime;
+        int response = record->startTime - record->arrivalTime;
+        // A process without a deadline gets an empty CSV field or a JSON null
+        char deadline[16];
+        if (record->deadline == NO_DEADLINE) {
+            snprintf(deadline, sizeof(deadline), "%s", (format == EXPORT_CSV) ? "" : "null");
+        } else {
+            snprintf(deadline, sizeof(deadline), "%d", record->deadline);
+        }
+        if (format == EXPORT_CSV) {
+            appendText(text, "%d,%s,%d,%d,%d,%d,%d,%s,%d,%d,%d,%d,%d\n",
+                       trial, algorithm, record->pid, record->arrivalTime, record->runtime, record->ioTime, record->priority, deadline,
+                       record->startTime, record->completionTime, turnaround, waiting, response);
+        } else {
+            appendText(text, "{\"trial\":%d,\"algorithm\":\"%s\",\"pid\":%d,\"arrival\":%d,\"runtime\":%d,\"io_time\":%d,"
+                       "\"priority\":%d,\"deadline\":%s,\"start\":%d,\"completion\":%d,\"turnaround\":%d,"
+                       "\"waiting\":%d,\"response\":%d}\n",
+                       trial, algorithm, record->pid, record->arrivalTime, record->runtime, record->ioTime, record->priority, deadline,
+                       record->startTime, record->completionTime, turnaround, waiting, response);
+        }
+    }
+}
+
+// Export a finished run. Process sinks need the per-process records of the run.
+void exportRunResult(ResultSink* sink, int trial, const char* algorithm, const RunResult* result) {
+    TextBuffer text;
+    text.capacity = 256;
+    text.length = 0;
+    text.data = (char*)malloc(text.capacity);
+    if (text.data == NULL) {
+        fprintf(stderr, "Error allocating export buffer!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (sink->kind == EXPORT_RUNS) {
+        formatRun(&text, sink->format, trial, algorithm, result);
+    } else {
+        if (result->records == NULL) {
+            fprintf(stderr, "Cannot export processes of a run that kept no per-process records!\n");
+            exit(EXIT_FAILURE);
+        }
+        formatProcesses(&text, sink->format, trial, algorithm, result);
+    }
+
+    pthread_mutex_lock(&sink->lock);
+    fwrite(text.data, 1, text.length, sink->file);
+    pthread_mutex_unlock(&sink->lock);
+    free(text.data);
+}
+
+// Flush and close a sink
+void closeResultSink(ResultSink* sink) {
+    if (fclose(sink->file) != 0) {
+        perror("Failed to write export file");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_destroy(&sink->lock);
+    free(sink->buffer);
+    free(sink);
+}
@@ -0,0 +1,33 @@
+#ifndef EXPORT_UTILS_H
+#define EXPORT_UTILS_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "result_utils.h"
+
+// Export formats
+#define EXPORT_CSV 0   // Comma-separated values with a header row
+#define EXPORT_JSONL 1 // One JSON object per line
+
+// What a sink records
+#define EXPORT_RUNS 0      // One record per (trial, algorithm) run
+#define EXPORT_PROCESSES 1 // One record per finished process of every run
+
+#define EXPORT_BUFFER_SIZE (1 << 20) // stdio buffer per sink, so records reach the disk in large writes
+
+// Buffered file that run results are exported to. Safe to share between threads: every run is
+// formatted privately and then written with a single locked fwrite.
+typedef struct ResultSink {
+    FILE* file;           // Output file
+    int format;           // EXPORT_CSV or EXPORT_JSONL
+    int kind;             // EXPORT_RUNS or EXPORT_PROCESSES
+    char* buffer;         // stdio buffer of EXPORT_BUFFER_SIZE bytes
+    pthread_mutex_t lock; // Serializes writes from concurrent runs
+} ResultSink;
+
+// Result sink utilities
+ResultSink* openResultSink(const char* path, int format, int kind);
+void exportRunResult(ResultSink* sink, int trial, const char* algorithm, const RunResult* result);
+void closeResultSink(ResultSink* sink);
+
+#endif
@@ -2,77 +2,66 @@
 #include <stdlib.h>
 #include "process_utils.h"
 #include "queue_utils.h"
+#include "event_utils.h"
 #include "simulation.h"
 
 // First-Come First-Served (FCFS) Scheduling
-void fcfs(Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput) {
+void fcfs(Process processes[], int numProcesses, const SimConfig* config, RunResult* result) {
     int currentTime = 0; // Simulation starts at time 0
     int completedProcesses = 0; // Tracks the number of completed processes
-    float totalTurnaroundTime = 0, totalWaitingTime = 0, totalResponseTime = 0; // Metrics for FCFS scheduling
-    Queue* queue = createQueue(numProcesses); // Initializing process queue
-    for (int i = 0; i < numProcesses; i++) 
-    {
-        enqueue(queue, processes[i]);
-    }
+    HandleQueue* queue = createHandleQueue(numProcesses); // Initializing process queue
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
     // Create the dynamic timeline
     Timeline* t = createTimeline(100);
 
-    printf("\nFirst-Come First-Served (FCFS) Scheduling:\n");
-
-    while (!isQueueEmpty(queue)) {
-        // Check the current time to ensure processes don't start at or beyond the 100th quantum
-        if (currentTime >= 100)
+    while (completedProcesses < numProcesses) {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
         {
-            printf("Stopping simulation since a process cannot be executed at or beyond the 100th quantum.\n");
+            result->stoppedAt = config->horizon;
             break;
         }
-        Process process = dequeue(queue);
+        // Admit every process that has arrived (or finished its I/O) while the previous one was running
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1) {
+            enqueueHandle(queue, arrived);
+        }
 
-        // Handle idle CPU time
-        if (currentTime < process.arrivalTime) {
-            updateTimeline(t, currentTime, process.arrivalTime - currentTime, '-');
-            currentTime = process.arrivalTime;
+        // Handle idle CPU time by jumping straight to the next arrival
+        if (isHandleQueueEmpty(queue)) {
+            currentTime = skipIdleTime(&arrivals, t, currentTime, config->horizon);
+            continue;
         }
+        int handle = dequeueHandle(queue);
+        Process* process = &processes[handle];
+        result->decisions++;
 
-        // Execute the process
-        process.startTime = currentTime;
-        updateTimeline(t, currentTime, process.runtime, process.name);
+        // Execute the process's CPU burst, once the CPU has switched to it
+        currentTime = switchContext(t, currentTime, process->pid, config->switchCost);
+        if (process->startTime == -1) {
+            process->startTime = currentTime;
+        }
+        updateTimeline(t, currentTime, process->remainingTime, process->pid);
 
         // Update metrics
-        currentTime += process.runtime;
-        process.completionTime = currentTime;
+        currentTime += process->remainingTime;
+        process->remainingTime = 0;
 
-        // Increment the number of completed processes
-        completedProcesses += 1;
+        // A process with I/O left blocks; otherwise it has finished
+        if (finishBurst(&arrivals, handle, currentTime)) {
+            process->completionTime = currentTime;
 
-        int turnaroundTime = process.completionTime - process.arrivalTime;
-        int waitingTime = turnaroundTime - process.runtime;
-        int responseTime = process.startTime - process.arrivalTime;
+            // Increment the number of completed processes
+            completedProcesses += 1;
 
-        totalTurnaroundTime += turnaroundTime;
-        totalWaitingTime += waitingTime;
-        totalResponseTime += responseTime;
-
-        // Print individual process metrics
-        printf("Process %c: Arrival Time = %d, Runtime = %d, Turnaround Time = %d, Waiting Time = %d, Response Time = %d\n",
-               process.name, process.arrivalTime, process.runtime, turnaroundTime, waitingTime, responseTime);
+            // Record individual process metrics
+            recordCompletion(result, process);
+        }
     }
 
-    // Print the timeline
-    printTimeline(t);
-
-    // Print averages
-    *avgTurnaroundTime = totalTurnaroundTime / completedProcesses;
-    *avgWaitingTime = totalWaitingTime / completedProcesses;
-    *avgResponseTime = totalResponseTime / completedProcesses;
-    *throughput = (float)completedProcesses / t->size;
-    
-    printf("\nAverage Turnaround Time: %.2f\n", *avgTurnaroundTime);
-    printf("Average Waiting Time: %.2f\n", *avgWaitingTime);
-    printf("Average Response Time: %.2f\n", *avgResponseTime);
-    printf("Throughput: %.2f processes/unit time\n", *throughput);
-
-    // Free timeline
-    freeTimeline(t);
-    freeQueue(queue);
+    // Compute averages; the result takes over the timeline
+    finishRunResult(result, t);
+    freeHandleQueue(queue);
+    freeArrivalCursor(&arrivals);
 }
\ No newline at end of file
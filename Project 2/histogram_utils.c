@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "histogram_utils.h"
+
+// Bucket of a value. Values with their highest bit at position HISTOGRAM_SUB_BITS + shift keep
+// their top HISTOGRAM_SUB_BITS + 1 bits; smaller values are their own bucket.
+static int bucketOf(int value) {
+    int shift = 31 - __builtin_clz((unsigned)value | HISTOGRAM_SUB_BUCKETS) - HISTOGRAM_SUB_BITS;
+    return shift * HISTOGRAM_SUB_BUCKETS + (value >> shift);
+}
+
+// Largest value that falls in a bucket
+static long long bucketHighest(int bucket) {
+    if (bucket < 2 * HISTOGRAM_SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    long long mantissa = bucket % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+// Start an empty histogram
+void initHistogram(Histogram* h) {
+    memset(h, 0, sizeof(Histogram));
+}
+
+// Record a value, which must not be negative
+void recordValue(Histogram* h, int value) {
+    if (value < 0) {
+        fprintf(stderr, "Histogram value %d is negative!\n", value);
+        exit(EXIT_FAILURE);
+    }
+    h->counts[bucketOf(value)]++;
+    h->total++;
+    if (value > h->max) {
+        h->max = value;
+    }
+}
+
+// Add the values recorded in one histogram to another
+void mergeHistogram(Histogram* into, const Histogram* from) {
+    if (from->total == 0) {
+        return;
+    }
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        into->counts[i] += from->counts[i];
+    }
+    into->total += from->total;
+    if (from->max > into->max) {
+        into->max = from->max;
+    }
+}
+
+// Value at a percentile given in tenths of a percent (nearest rank), e.g. 999 for p99.9. It is the
+// highest value of the bucket the rank falls in, but never more than the largest value recorded.
+int histogramPercentile(const Histogram* h, int permille) {
+    long long rank = ((long long)permille * h->total + 999) / 1000;
+    if (rank < 1) {
+        rank = 1;
+    }
+    long long seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            long long highest = bucketHighest(i);
+            return (highest < h->max) ? (int)highest : h->max;
+        }
+    }
+    return h->max;
+}
+
+// Print the 50th, 90th, 99th and 99.9th percentiles and the maximum of a histogram
+void printHistogram(const Histogram* h, const char* label) {
+    if (h->total == 0) {
+        printf("%s: no values\n", label);
+        return;
+    }
+    printf("%s: p50=%d, p90=%d, p99=%d, p99.9=%d, max=%d\n", label, histogramPercentile(h, 500),
+           histogramPercentile(h, 900), histogramPercentile(h, 990), histogramPercentile(h, 999), h->max);
+}
@@ -0,0 +1,26 @@
+#ifndef HISTOGRAM_UTILS_H
+#define HISTOGRAM_UTILS_H
+
+// Log-linear bucketing in the style of HdrHistogram: values below 2 * HISTOGRAM_SUB_BUCKETS get a
+// bucket each, and every power of two above that is split into HISTOGRAM_SUB_BUCKETS equal buckets,
+// so any non-negative int is recorded to within 1 / HISTOGRAM_SUB_BUCKETS (under 1%) of its value.
+#define HISTOGRAM_SUB_BITS 7
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS ((31 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+// Distribution of non-negative integer values. Histograms of the same layout merge by adding their
+// counts, so runs recorded separately (or on different threads) can be combined in any order.
+typedef struct Histogram {
+    long long counts[HISTOGRAM_BUCKETS]; // Values recorded in each bucket
+    long long total;                     // Values recorded
+    int max;                             // Largest value recorded (exact)
+} Histogram;
+
+// Histogram utilities
+void initHistogram(Histogram* h);
+void recordValue(Histogram* h, int value);
+void mergeHistogram(Histogram* into, const Histogram* from);
+int histogramPercentile(const Histogram* h, int permille);
+void printHistogram(const Histogram* h, const char* label);
+
+#endif
@@ -3,262 +3,115 @@
 #include <string.h>
 #include "process_utils.h"
 #include "queue_utils.h"
+#include "event_utils.h"
 #include "simulation.h"
+#include "aging_utils.h"
 
 #define NUM_RUNS 5
-#define MAX_TIME 100
-
-static int waitingInLevel[1000]; // Track how long a process has waited at its current level
-
-// Runs one simulation of HPF (non-preemptive) for one "run"
-void simulateHPFNonPreemptive(int runIndex, Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput)
-{
-    printf("=== HPF Non-Preemptive Run #%d ===\n", runIndex);
-    runNonPreemptive(processes, numProcesses, avgTurnaroundTime, avgWaitingTime, avgResponseTime, throughput);
-}
 
 // Non-preemptive approach: once a process starts, it runs to completion.
-void runNonPreemptive(Process *processes, int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput)
+void runNonPreemptive(Process *processes, int numProcesses, const SimConfig* config, RunResult* result)
 {
-    Queue *queues[4];
-    for (int i = 0; i < 4; i++)
-    {
-        queues[i] = createQueue(numProcesses);
-    }
+    // The queues hold handles into the process table, so no process ever has to be looked up by value
+    ProcessTable *table = createProcessTable(numProcesses);
+    AgingQueues *queues = createAgingQueues(numProcesses); // One level per priority; waiting processes age up
     Timeline *timeline = createTimeline(200);
 
-    // Identify active processes (arrival <= 99)
-    int totalActive = 0;
-    for (int i = 0; i < numProcesses; i++)
-    {
-        if (processes[i].arrivalTime <= 99)
-        {
-            totalActive++;
-        }
-        processes[i].startTime = -1;
-        processes[i].completionTime = 0;
-        processes[i].remainingTime = processes[i].runtime;
-        waitingInLevel[i] = 0;
-    }
-
+    // Active processes arrive before the horizon. Those that have arrived are counted as they do, so only
+    // the next process the cursor reaches tells whether any are still to come.
+    int active = 0;
     int finished = 0, currentTime = 0;
-    Process *running = NULL;
-    int runningIndex = -1;
+    int running = -1;
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
 
-    // Loop until all active processes finish or time exceeds MAX_TIME
-    while (finished < totalActive && currentTime < MAX_TIME)
+    // Loop until all active processes finish or time reaches the horizon
+    while ((finished < active || peekNewArrivalTime(&arrivals) < config->horizon) && currentTime < config->horizon)
     {
-        // Enqueue newly arrived processes (priority-1 as array index)
-        for (int i = 0; i < numProcesses; i++)
+        // Enqueue newly arrived processes and those that finished their I/O (priority-1 as array index)
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
         {
-            if (processes[i].arrivalTime == currentTime && processes[i].arrivalTime <= 99)
+            if (arrived == table->count)
             {
-                enqueue(queues[processes[i].priority - 1], processes[i]);
-            }
-        }
-
-        // Pick next process from highest non-empty queue if not running one
-        if (!running)
-        {
-            for (int q = 0; q < 4; q++)
-            {
-                if (!isQueueEmpty(queues[q]))
+                // First arrival: the process joins the table
+                addProcessTableRow(table, &processes[arrived]);
+                if (table->arrivalTime[arrived] < config->horizon)
                 {
-                    Process p = dequeue(queues[q]);
-                    for (int i = 0; i < numProcesses; i++)
-                    {
-                        if (processes[i].name == p.name &&
-                            processes[i].arrivalTime == p.arrivalTime &&
-                            processes[i].runtime == p.runtime)
-                        {
-                            runningIndex = i;
-                            break;
-                        }
-                    }
-                    running = &processes[runningIndex];
-                    if (running->startTime == -1)
-                    {
-                        running->startTime = currentTime;
-                    }
-                    break;
+                    active++;
                 }
             }
-        }
-
-        // Run the current process for one quantum
-        if (running)
-        {
-            updateTimeline(timeline, currentTime, 1, running->name);
-            running->remainingTime--;
-            // If done, record completion and reset
-            if (running->remainingTime == 0)
+            if (table->arrivalTime[arrived] < config->horizon)
             {
-                running->completionTime = currentTime + 1;
-                running = NULL;
-                runningIndex = -1;
-                finished++;
+                enqueueWaiting(queues, arrived, table->priority[arrived] - 1);
             }
         }
-        else
+
+        // Pick next process from highest non-empty queue if not running one
+        if (running == -1 && !isAgingQueuesEmpty(queues))
         {
-            // CPU idle
-            updateTimeline(timeline, currentTime, 1, '-');
+            running = dequeueLevel(queues, highestWaitingLevel(queues));
+            result->decisions++;
         }
 
-        // Aging: increment waiting counter for processes in queues
-        for (int q = 0; q < 4; q++)
+        // Run the current process for one quantum. If nothing is waiting there is nobody to age,
+        // so jump straight to its completion or the next arrival, whichever comes first. A process that
+        // was just picked first waits for the CPU to switch to it.
+        int step = 1;
+        if (running != -1)
         {
-            int size = queues[q]->size;
-            int front = queues[q]->front;
-            for (int s = 0; s < size; s++)
+            if (isAgingQueuesEmpty(queues))
             {
-                int idx = (front + s) % queues[q]->capacity;
-                Process *pr = &queues[q]->processes[idx];
-                for (int i = 0; i < numProcesses; i++)
-                {
-                    if (pr->name == processes[i].name &&
-                        pr->arrivalTime == processes[i].arrivalTime &&
-                        pr->runtime == processes[i].runtime)
-                    {
-                        waitingInLevel[i]++;
-                        break;
-                    }
-                }
+                int runUntil = currentTime + table->remainingTime[running];
+                step = nextEventTime(&arrivals, currentTime, runUntil < config->horizon ? runUntil : config->horizon) - currentTime;
             }
-        }
-
-        // Bump any process that has waited >= 5 quanta in the same level
-        for (int q = 1; q < 4; q++)
-        {
-            int size = queues[q]->size;
-            while (size--)
+            currentTime = switchContext(timeline, currentTime, processes[running].pid, config->switchCost);
+            if (table->startTime[running] == -1)
             {
-                Process temp = dequeue(queues[q]);
-                int realIdx = -1;
-                for (int i = 0; i < numProcesses; i++)
-                {
-                    if (temp.name == processes[i].name &&
-                        temp.arrivalTime == processes[i].arrivalTime &&
-                        temp.runtime == processes[i].runtime)
-                    {
-                        realIdx = i;
-                        break;
-                    }
-                }
-                if (waitingInLevel[realIdx] >= 5 && q > 0)
+                table->startTime[running] = currentTime;
+            }
+            updateTimeline(timeline, currentTime, step, processes[running].pid);
+            table->remainingTime[running] -= step;
+            // If done, record completion and reset; a process with I/O left blocks until it is done
+            if (table->remainingTime[running] == 0)
+            {
+                if (finishBurst(&arrivals, running, currentTime + step))
                 {
-                    temp.priority--;
-                    enqueue(queues[q - 1], temp);
-                    waitingInLevel[realIdx] = 0;
+                    table->completionTime[running] = currentTime + step;
+                    finished++;
                 }
                 else
                 {
-                    enqueue(queues[q], temp);
+                    table->remainingTime[running] = processes[running].remainingTime;
                 }
+                running = -1;
             }
         }
-
-        currentTime += 1;
-    }
-
-    printRunStatisticsNonPreemptive(processes, numProcesses, timeline->size, timeline, avgTurnaroundTime, avgWaitingTime, avgResponseTime, throughput);
-    for (int i = 0; i < 4; i++)
-    {
-        freeQueue(queues[i]);
-    }
-    freeTimeline(timeline);
-}
-
-// Prints the per-process and overall statistics, along with the timeline
-void printRunStatisticsNonPreemptive(Process *processes, int numProcesses, int totalRunTime, Timeline *timeline, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput)
-{
-    printf("\nProcesses (arrived <= 99):\n");
-    printf("Name\tArrival\tRuntime\tPriority\tStart\tCompletion\n");
-    for (int i = 0; i < numProcesses; i++)
-    {
-        if (processes[i].arrivalTime <= 99 && processes[i].startTime != -1)
+        else
         {
-            printf("%c\t%d\t%d\t%d\t\t%d\t%d\n",
-                   processes[i].name,
-                   processes[i].arrivalTime,
-                   processes[i].runtime,
-                   processes[i].priority,
-                   processes[i].startTime,
-                   processes[i].completionTime);
+            // CPU idle, and the queues are empty since nothing was picked
+            step = skipIdleTime(&arrivals, timeline, currentTime, config->horizon) - currentTime;
         }
-    }
-
-    printTimeline(timeline);
 
-    double sumTurnaround[4] = {0};
-    double sumWaiting[4] = {0};
-    double sumResponse[4] = {0};
-    int countP[4] = {0};
+        // Aging: every waiting process has waited one more step, and those that have waited 5 in the
+        // same level are bumped up one
+        ageWaiting(queues);
 
-    double sumT = 0, sumW = 0, sumR = 0;
-    int totalFinished = 0;
-
-    // Calculate stats per original priority
-    for (int i = 0; i < numProcesses; i++)
-    {
-        if (processes[i].arrivalTime <= 99 && processes[i].startTime != -1 && processes[i].completionTime != 0)
-        {
-            int p = processes[i].priority - 1;
-            int turnaround = processes[i].completionTime - processes[i].arrivalTime;
-            int waiting = turnaround - processes[i].runtime;
-            int response = processes[i].startTime - processes[i].arrivalTime;
-
-            sumTurnaround[p] += turnaround;
-            sumWaiting[p] += waiting;
-            sumResponse[p] += response;
-            countP[p]++;
-
-            sumT += turnaround;
-            sumW += waiting;
-            sumR += response;
-            totalFinished++;
-        }
+        currentTime += step;
     }
 
-    printf("\nPer-priority stats:\n");
-    for (int p = 0; p < 4; p++)
+    storeProcessTable(table, processes);
+    // Record every process that arrived before the horizon and ran to completion
+    result->reportByPriority = 1;
+    for (int i = 0; i < table->count; i++)
     {
-        if (countP[p] > 0)
-        {
-            /**double avgT = sumTurnaround[p] / countP[p];
-            double avgW = sumWaiting[p] / countP[p];
-            double avgR = sumResponse[p] / countP[p];**/
-            *avgTurnaroundTime = sumTurnaround[p] / countP[p];
-            *avgWaitingTime = sumWaiting[p] / countP[p];
-            *avgResponseTime = sumResponse[p] / countP[p];
-            *throughput = (float)countP[p] / totalRunTime;
-            printf("Priority %d: Throughput=%.5f\n", p + 1, *throughput);
-            printf("  Avg Turnaround=%.2f, Avg Waiting=%.2f, Avg Response=%.2f\n",
-                   *avgTurnaroundTime, *avgWaitingTime, *avgResponseTime);
-        }
-        else
+        if (processes[i].arrivalTime < config->horizon && processes[i].startTime != -1 && processes[i].completionTime != 0)
         {
-            printf("Priority %d: Throughput=0 (no processes finished)\n", p + 1);
+            recordCompletion(result, &processes[i]);
         }
     }
-
-    if (totalFinished > 0)
-    {
-        /**double avgT = sumT / totalFinished;
-        double avgW = sumW / totalFinished;
-        double avgR = sumR / totalFinished;
-        double throughput = (double)totalFinished / totalRunTime;**/
-        *avgTurnaroundTime = sumT / totalFinished;
-        *avgWaitingTime = sumW / totalFinished;
-        *avgResponseTime = sumR / totalFinished;
-        *throughput = (float)totalFinished / totalRunTime;
-        printf("\nOverall stats:\n");
-        printf("Throughput = %.5f processes/quantum\n", *throughput);
-        printf("Avg Turnaround=%.2f, Avg Waiting=%.2f, Avg Response=%.2f\n",
-               *avgTurnaroundTime, *avgWaitingTime, *avgResponseTime);
-    }
-    else
-    {
-        printf("\nNo processes started.\n");
-    }
+    finishRunResult(result, timeline); // The result takes over the timeline
+    freeAgingQueues(queues);
+    freeProcessTable(table);
+    freeArrivalCursor(&arrivals);
 }
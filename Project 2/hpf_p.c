@@ -3,270 +3,123 @@
 #include <string.h>
 #include "process_utils.h"
 #include "queue_utils.h"
+#include "event_utils.h"
 #include "simulation.h"
+#include "aging_utils.h"
 
 #define NUM_RUNS 5
-#define MAX_TIME 100
-
-static int waitingInLevel[1000]; // Tracks waiting time at the current level
-
-// Runs one simulation of HPF Preemptive for a single run
-void simulateHPFPreemptive(int runIndex, Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput)
-{
-    printf("=== HPF Preemptive Run #%d ===\n", runIndex);
-
-    runPreemptive(processes, numProcesses, avgTurnaroundTime, avgWaitingTime, avgResponseTime, throughput);
-}
 
 // Preemptive approach: 1-quantum Round Robin within the highest non-empty queue
-void runPreemptive(Process *processes, int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput)
+void runPreemptive(Process *processes, int numProcesses, const SimConfig* config, RunResult* result)
 {
-    Queue *queues[4];
-    for (int i = 0; i < 4; i++)
-    {
-        queues[i] = createQueue(numProcesses);
-    }
+    // The queues hold handles into the process table, so no process ever has to be looked up by value
+    ProcessTable *table = createProcessTable(numProcesses);
+    AgingQueues *queues = createAgingQueues(numProcesses); // One level per priority; waiting processes age up
     Timeline *timeline = createTimeline(200);
 
-    int totalActive = 0;
-    for (int i = 0; i < numProcesses; i++)
-    {
-        if (processes[i].arrivalTime <= 99)
-        {
-            totalActive++;
-        }
-        processes[i].startTime = -1;
-        processes[i].completionTime = 0;
-        processes[i].remainingTime = processes[i].runtime;
-        waitingInLevel[i] = 0;
-    }
-
+    // Active processes arrive before the horizon. Those that have arrived are counted as they do, so only
+    // the next process the cursor reaches tells whether any are still to come.
+    int active = 0;
     int finished = 0;
     int currentTime = 0;
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
 
     // Keep going until all active processes finish or time is too large
-    while (finished < totalActive && currentTime < MAX_TIME)
+    while ((finished < active || peekNewArrivalTime(&arrivals) < config->horizon) && currentTime < config->horizon)
     {
-        // Enqueue newly arrived processes
-        for (int i = 0; i < numProcesses; i++)
+        // Enqueue newly arrived processes and those that finished their I/O
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
         {
-            if (processes[i].arrivalTime == currentTime && processes[i].arrivalTime <= 99)
+            if (arrived == table->count)
             {
-                enqueue(queues[processes[i].priority - 1], processes[i]);
+                // First arrival: the process joins the table
+                addProcessTableRow(table, &processes[arrived]);
+                if (table->arrivalTime[arrived] < config->horizon)
+                {
+                    active++;
+                }
             }
-        }
-
-        // Choose the highest non-empty queue
-        int chosenQueue = -1;
-        for (int q = 0; q < 4; q++)
-        {
-            if (!isQueueEmpty(queues[q]))
+            if (table->arrivalTime[arrived] < config->horizon)
             {
-                chosenQueue = q;
-                break;
+                enqueueWaiting(queues, arrived, table->priority[arrived] - 1);
             }
         }
 
-        // If no ready process, CPU is idle for this quantum
+        // Choose the highest non-empty queue
+        int chosenQueue = highestWaitingLevel(queues);
+
+        // If no ready process, CPU is idle until the next arrival
+        int step = 1;
         if (chosenQueue == -1)
         {
-            updateTimeline(timeline, currentTime, 1, '-');
+            step = skipIdleTime(&arrivals, timeline, currentTime, config->horizon) - currentTime;
         }
         else
         {
-            Process p = dequeue(queues[chosenQueue]);
-            int realIdx = -1;
-            for (int i = 0; i < numProcesses; i++)
-            {
-                if (p.name == processes[i].name &&
-                    p.arrivalTime == processes[i].arrivalTime &&
-                    p.runtime == processes[i].runtime)
-                {
-                    realIdx = i;
-                    break;
-                }
-            }
-            if (processes[realIdx].startTime == -1)
-            {
-                processes[realIdx].startTime = currentTime;
-            }
+            int handle = dequeueLevel(queues, chosenQueue);
+            result->decisions++;
 
-            // Run for 1 quantum
-            updateTimeline(timeline, currentTime, 1, p.name);
-            processes[realIdx].remainingTime--;
-            if (processes[realIdx].remainingTime <= 0)
+            // Run for 1 quantum, or until the next event if it is the only ready process, once the CPU has switched to it
+            if (isAgingQueuesEmpty(queues))
             {
-                processes[realIdx].completionTime = currentTime + 1;
-                finished++;
+                int runUntil = currentTime + table->remainingTime[handle];
+                step = nextEventTime(&arrivals, currentTime, runUntil < config->horizon ? runUntil : config->horizon) - currentTime;
             }
-            else
+            currentTime = switchContext(timeline, currentTime, processes[handle].pid, config->switchCost);
+            if (table->startTime[handle] == -1)
             {
-                // If not finished, requeue at the same priority level
-                enqueue(queues[chosenQueue], processes[realIdx]);
+                table->startTime[handle] = currentTime;
             }
-        }
-
-        // Aging: increment wait time for processes still in queues
-        for (int q = 0; q < 4; q++)
-        {
-            int size = queues[q]->size;
-            int front = queues[q]->front;
-            for (int s = 0; s < size; s++)
+            updateTimeline(timeline, currentTime, step, processes[handle].pid);
+            table->remainingTime[handle] -= step;
+            if (table->remainingTime[handle] <= 0)
             {
-                int idx = (front + s) % queues[q]->capacity;
-                Process *pr = &queues[q]->processes[idx];
-                for (int i = 0; i < numProcesses; i++)
+                // Finished, or blocked until its I/O is done
+                if (finishBurst(&arrivals, handle, currentTime + step))
                 {
-                    if (pr->name == processes[i].name &&
-                        pr->arrivalTime == processes[i].arrivalTime &&
-                        pr->runtime == processes[i].runtime)
-                    {
-                        waitingInLevel[i]++;
-                        break;
-                    }
-                }
-            }
-        }
-
-        // Bump any process that has waited >= 5 quanta in the same level
-        for (int q = 1; q < 4; q++)
-        {
-            int size = queues[q]->size;
-            while (size--)
-            {
-                Process temp = dequeue(queues[q]);
-                int realIdx = -1;
-                for (int i = 0; i < numProcesses; i++)
-                {
-                    if (temp.name == processes[i].name &&
-                        temp.arrivalTime == processes[i].arrivalTime &&
-                        temp.runtime == processes[i].runtime)
-                    {
-                        realIdx = i;
-                        break;
-                    }
-                }
-                if (waitingInLevel[realIdx] >= 5)
-                {
-                    if (q > 0)
-                    {
-                        temp.priority--;
-                        enqueue(queues[q - 1], temp);
-                        waitingInLevel[realIdx] = 0;
-                    }
-                    else
-                    {
-                        // Already in top queue
-                        enqueue(queues[q], temp);
-                    }
+                    table->completionTime[handle] = currentTime + step;
+                    finished++;
                 }
                 else
                 {
-                    enqueue(queues[q], temp);
+                    table->remainingTime[handle] = processes[handle].remainingTime;
                 }
             }
+            else if (step > 1)
+            {
+                // It was requeued and aged alone after each quantum it ran; apply all of that at once
+                ageLoneHandle(queues, handle, chosenQueue, step);
+                currentTime += step;
+                continue;
+            }
+            else
+            {
+                // If not finished, requeue at the same priority level
+                requeueWaiting(queues, handle, chosenQueue);
+            }
         }
 
-        currentTime += 1;
-    }
-
-    printRunStatisticsPreemptive(processes, numProcesses, timeline->size, timeline, avgTurnaroundTime, avgWaitingTime, avgResponseTime, throughput);
-    for (int i = 0; i < 4; i++)
-    {
-        freeQueue(queues[i]);
-    }
-    freeTimeline(timeline);
-}
-
-// Prints details of each process plus overall scheduling stats
-void printRunStatisticsPreemptive(Process *processes, int numProcesses, int totalRunTime, Timeline *timeline, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput)
-{
-    printf("\nProcesses (arrived <= 99):\n");
-    printf("Name\tArrival\tRuntime\tPriority\tStart\tCompletion\n");
-    for (int i = 0; i < numProcesses; i++)
-    {
-        if (processes[i].arrivalTime <= 99 && processes[i].startTime != -1)
-        {
-            printf("%c\t%d\t%d\t%d\t\t%d\t%d\n",
-                   processes[i].name,
-                   processes[i].arrivalTime,
-                   processes[i].runtime,
-                   processes[i].priority,
-                   processes[i].startTime,
-                   processes[i].completionTime);
-        }
-    }
-
-    printTimeline(timeline);
-
-    double sumTurnaround[4] = {0};
-    double sumWaiting[4] = {0};
-    double sumResponse[4] = {0};
-    int countP[4] = {0};
-
-    double sumT = 0, sumW = 0, sumR = 0;
-    int totalFinished = 0;
-
-    for (int i = 0; i < numProcesses; i++)
-    {
-        if (processes[i].arrivalTime <= 99 && processes[i].startTime != -1 && processes[i].completionTime != 0)
-        {
-            int p = processes[i].priority - 1;
-            int turnaround = processes[i].completionTime - processes[i].arrivalTime;
-            int waiting = turnaround - processes[i].runtime;
-            int response = processes[i].startTime - processes[i].arrivalTime;
-
-            sumTurnaround[p] += turnaround;
-            sumWaiting[p] += waiting;
-            sumResponse[p] += response;
-            countP[p]++;
+        // Aging: every waiting process has waited one more step, and those that have waited 5 in the
+        // same level are bumped up one (the top queue cannot be bumped)
+        ageWaiting(queues);
 
-            sumT += turnaround;
-            sumW += waiting;
-            sumR += response;
-            totalFinished++;
-        }
+        currentTime += step;
     }
 
-    printf("\nPer-priority stats:\n");
-    for (int p = 0; p < 4; p++)
+    storeProcessTable(table, processes);
+    // Record every process that arrived before the horizon and ran to completion
+    result->reportByPriority = 1;
+    for (int i = 0; i < table->count; i++)
     {
-        if (countP[p] > 0)
+        if (processes[i].arrivalTime < config->horizon && processes[i].startTime != -1 && processes[i].completionTime != 0)
         {
-            /**double avgT = sumTurnaround[p] / countP[p];
-            double avgW = sumWaiting[p] / countP[p];
-            double avgR = sumResponse[p] / countP[p];**/
-            *avgTurnaroundTime = sumTurnaround[p] / countP[p];
-            *avgWaitingTime = sumWaiting[p] / countP[p];
-            *avgResponseTime = sumResponse[p] / countP[p];
-            *throughput = (float)countP[p] / totalRunTime;
-            printf("Priority %d: Throughput=%.5f\n", p + 1, *throughput);
-            printf("  Avg Turnaround=%.2f, Avg Waiting=%.2f, Avg Response=%.2f\n",
-                   *avgTurnaroundTime, *avgWaitingTime, *avgResponseTime);
+            recordCompletion(result, &processes[i]);
         }
-        else
-        {
-            printf("Priority %d: Throughput=0 (no processes finished)\n", p + 1);
-        }
-    }
-
-    if (totalFinished > 0)
-    {
-        /**double avgT = sumT / totalFinished;
-        double avgW = sumW / totalFinished;
-        double avgR = sumR / totalFinished;
-        double throughput = (double)totalFinished / totalRunTime;**/
-        *avgTurnaroundTime = sumT / totalFinished;
-        *avgWaitingTime = sumW / totalFinished;
-        *avgResponseTime = sumR / totalFinished;
-        *throughput = (float)totalFinished / totalRunTime;
-        printf("\nOverall stats:\n");
-        printf("Throughput = %.5f processes/quantum\n", *throughput);
-        printf("Avg Turnaround=%.2f, Avg Waiting=%.2f, Avg Response=%.2f\n",
-               *avgTurnaroundTime, *avgWaitingTime, *avgResponseTime);
-    }
-    else
-    {
-        printf("\nNo processes started.\n");
     }
+    finishRunResult(result, timeline); // The result takes over the timeline
+    freeAgingQueues(queues);
+    freeProcessTable(table);
+    freeArrivalCursor(&arrivals);
 }
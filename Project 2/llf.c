@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "event_utils.h"
+#include "simulation.h"
+
+// Laxity of a process plus the current time: its deadline minus the time it still needs, I/O included.
+// Waiting does not change it, so the ready heap can be keyed on it; running raises it by one per quantum.
+static long long laxityKey(const Process* process)
+{
+    return (long long)process->deadline - remainingWork(process);
+}
+
+// Least Laxity First: the ready process with the least laxity (time left until its deadline minus the
+// run time it still needs) runs. Waiting processes lose laxity while the running one keeps its own, so
+// the running process is preempted as soon as a waiting one has less laxity, and at every arrival.
+void leastLaxityFirst(Process processes[], int numProcesses, const SimConfig* config, RunResult* result)
+{
+    ReadyHeap* ready = createReadyHeap(numProcesses); // Waiting processes keyed on laxityKey()
+    Timeline* t = createTimeline(100);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
+    int currentTime = 0, completed = 0;
+
+    while (completed < numProcesses)
+    {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
+        {
+            result->stoppedAt = config->horizon;
+            break;
+        }
+
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
+        {
+            heapInsert(ready, arrived, laxityKey(&processes[arrived]));
+        }
+
+        if (isHeapEmpty(ready))
+        {
+            // CPU is idle until the next arrival
+            currentTime = skipIdleTime(&arrivals, t, currentTime, config->horizon);
+            continue;
+        }
+
+        int handle = heapPop(ready);
+        Process* process = &processes[handle];
+        result->decisions++;
+
+        // Run until it finishes, the next process arrives or the best waiting process overtakes it.
+        // Equal laxities go to the smaller handle, as in the heap. A context switch to it delays the whole step.
+        long long runUntil = currentTime + process->remainingTime;
+        if (!isHeapEmpty(ready))
+        {
+            int rival = heapPeek(ready);
+            long long overtakeAt = currentTime + ready->key[rival] - laxityKey(process) + (handle < rival);
+            if (overtakeAt < runUntil)
+            {
+                runUntil = overtakeAt;
+            }
+        }
+        int step = nextEventTime(&arrivals, currentTime, runUntil < config->horizon ? (int)runUntil : config->horizon) - currentTime;
+        currentTime = switchContext(t, currentTime, process->pid, config->switchCost);
+        if (process->startTime == -1)
+        {
+            process->startTime = currentTime;
+        }
+        updateTimeline(t, currentTime, step, process->pid);
+        process->remainingTime -= step;
+        currentTime += step;
+
+        if (process->remainingTime == 0)
+        {
+            // Finished, or blocked until its I/O is done
+            if (finishBurst(&arrivals, handle, currentTime))
+            {
+                process->completionTime = currentTime;
+                recordCompletion(result, process);
+                completed++;
+            }
+        }
+        else
+        {
+            heapInsert(ready, handle, laxityKey(process));
+        }
+    }
+
+    // Calculate averages for this run; the result takes over the timeline
+    finishRunResult(result, t);
+
+    // Free allocated resources
+    freeReadyHeap(ready);
+    freeArrivalCursor(&arrivals);
+}
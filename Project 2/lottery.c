@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "event_utils.h"
+#include "rng_utils.h"
+#include "simulation.h"
+
+// Tickets of a priority level. Priority 1 is the highest, so priorities 1 to 4 hold 4 down to 1 tickets.
+int lotteryTickets(int priority)
+{
+    return NUM_PRIORITIES + 1 - priority;
+}
+
+// Draw a ticket among those held and return its holder. A lone holder wins without a draw.
+int drawLottery(TicketTree* tickets, Rng* rng)
+{
+    if (tickets->size == 1)
+    {
+        return ticketTreeFind(tickets, 0);
+    }
+    // The modulo bias is at most total / 2^64, far below anything a simulation can observe
+    return ticketTreeFind(tickets, (long long)(rngNext(rng) % (uint64_t)tickets->total));
+}
+
+// Lottery scheduling: every quantum a ticket is drawn from those held by the runnable processes and
+// its holder runs, so on average each process gets the CPU in proportion to its tickets. The tickets
+// are kept in a Fenwick tree, so a draw takes O(log n) however many processes are runnable.
+void lottery(Process processes[], int numProcesses, const SimConfig* config, RunResult* result)
+{
+    TicketTree* tickets = createTicketTree(numProcesses);
+    Timeline* t = createTimeline(100);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
+    Rng rng;
+    rngStream(&rng, config->seed, LOTTERY_STREAM_BASE + config->trial);
+
+    long long levelTickets[NUM_PRIORITIES] = {0}; // Tickets held by the runnable processes of each priority level
+    int currentTime = 0, completed = 0;
+    result->reportByPriority = 1;
+    result->reportShares = 1;
+
+    while (completed < numProcesses)
+    {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
+        {
+            result->stoppedAt = config->horizon;
+            break;
+        }
+
+        // New processes, and those that finished their I/O, join the draw
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
+        {
+            ticketTreeSet(tickets, arrived, lotteryTickets(processes[arrived].priority));
+            levelTickets[processes[arrived].priority - 1] += lotteryTickets(processes[arrived].priority);
+        }
+
+        if (isTicketTreeEmpty(tickets))
+        {
+            // CPU is idle until the next arrival
+            currentTime = skipIdleTime(&arrivals, t, currentTime, config->horizon);
+            continue;
+        }
+
+        int winner = drawLottery(tickets, &rng);
+        Process* process = &processes[winner];
+        result->decisions++;
+        // Run the winner for one quantum, or less if it finishes first. A process that is alone would win
+        // every draw, so it keeps the CPU until it finishes or the quantum in which the next process arrives is over.
+        // A context switch to it delays the slice.
+        int runUntil = currentTime + process->remainingTime;
+        if (runUntil > config->horizon)
+        {
+            runUntil = config->horizon;
+        }
+        int slice = config->quantum;
+        if (tickets->size == 1)
+        {
+            slice = nextEventTime(&arrivals, currentTime, runUntil) - currentTime;
+            slice = (slice + config->quantum - 1) / config->quantum * config->quantum;
+        }
+        if (slice > runUntil - currentTime)
+        {
+            slice = runUntil - currentTime;
+        }
+        currentTime = switchContext(t, currentTime, process->pid, config->switchCost);
+        if (process->startTime == -1)
+        {
+            process->startTime = currentTime;
+        }
+        updateTimeline(t, currentTime, slice, process->pid);
+        result->cpuTime[process->priority - 1] += slice;
+        recordShares(result, levelTickets, slice);
+        process->remainingTime -= slice;
+        currentTime += slice;
+
+        if (process->remainingTime == 0)
+        {
+            // Finished processes leave the draw, and so do those that block until their I/O is done
+            ticketTreeSet(tickets, winner, 0);
+            levelTickets[process->priority - 1] -= lotteryTickets(process->priority);
+            if (finishBurst(&arrivals, winner, currentTime))
+            {
+                process->completionTime = currentTime;
+                recordCompletion(result, process);
+                completed++;
+            }
+        }
+    }
+
+    // Calculate averages for this run; the result takes over the timeline
+    finishRunResult(result, t);
+
+    // Free allocated resources
+    freeTicketTree(tickets);
+    freeArrivalCursor(&arrivals);
+}
@@ -6,155 +6,490 @@
 #include "process_utils.h"
 #include "queue_utils.h"
 #include "simulation.h"
+#include "runner.h"
+#include "rng_utils.h"
+#include "workload_utils.h"
+#include "arena_utils.h"
 
-void copyProcesses(Process *dest, Process* source, int numProcesses)
+int main(int argc, char **argv)
 {
-    for(int i = 0; i < numProcesses; i++)
+	int numProcesses;
+    int runs = 5;
+    int numThreads = 0;  // 0 runs the trials one after another with full output
+    SimConfig config = defaultSimConfig();
+    const char* runsPath = NULL;      // --export: per-run records
+    const char* processesPath = NULL; // --export-processes: per-process records
+    int exportFormat = EXPORT_CSV;
+    const char* tracePath = NULL;      // --trace: replay this workload instead of generating one
+    const char* writeTracePath = NULL; // --write-trace: save the first run's workload as a binary trace
+    int horizonGiven = 0;
+    int runsGiven = 0;
+    double ciTarget = 0;  // --ci-target: 0 runs the trials once, otherwise the relative CI half width to reach
+    int maxTrials = DEFAULT_MAX_TRIALS;
+    uint64_t seed = (uint64_t)time(NULL);
+
+    // Options: --horizon <quanta> sets the quantum at or beyond which no process may start,
+    // --trials <n> sets the number of runs, --ci-target <percent> keeps adding that many runs until the
+    // 95% confidence interval of every algorithm's mean turnaround time is within percent of the mean
+    // (or --max-trials <n> runs are done), --threads <n> runs all trials and algorithms
+    // concurrently on n threads and prints only the final averages, --seed <n> fixes the seed
+    // so that a run can be reproduced exactly, --verbosity <0-2> (or --quiet for 0) sets how
+    // much of each run is printed, --export and --export-processes write per-run and per-process
+    // records to files as --format csv (the default) or jsonl, --trace <file> replays a text or
+    // binary trace in every run and --write-trace <file> saves the first run's workload as a binary trace,
+    // --deadline-factor <n> gives generated processes deadlines 1 to n runtimes after arrival (0 none),
+    // --io-mix <percent> makes that share of generated processes alternate CPU bursts with I/O bursts,
+    // --quantum <n> sets the Round Robin time slice, --cfs-latency <n> the CFS target latency,
+    // --predict-alpha <a> the weight of the latest burst in the predicted SJF and SRTF burst estimates,
+    // --select auto|heap|scan whether SJF and SRTF pick the shortest ready process from a binary heap, by
+    // scanning, or (the default) by scanning only in runs small enough for the scan to be faster,
+    // --mlfq-quanta <q1,q2,...> sets the number of MLFQ levels and their time slices, --mlfq-boost <n>
+    // how often MLFQ boosts (0 never), --cpus <n> simulates n CPUs sharing a global run queue or, with
+    // --queues per-core, each with its own, --migration-cost <n> charges n quanta whenever a
+    // process moves to another CPU and --switch-cost <n> whenever a CPU switches to another process
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--horizon") == 0 && i + 1 < argc)
+        {
+            config.horizon = atoi(argv[++i]);
+            horizonGiven = 1;
+        }
+        else if (strcmp(argv[i], "--trials") == 0 && i + 1 < argc)
+        {
+            runs = atoi(argv[++i]);
+            runsGiven = 1;
+        }
+        else if (strcmp(argv[i], "--ci-target") == 0 && i + 1 < argc)
+        {
+            ciTarget = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-trials") == 0 && i + 1 < argc)
+        {
+            maxTrials = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            numThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--verbosity") == 0 && i + 1 < argc)
+        {
+            config.verbosity = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--quiet") == 0)
+        {
+            config.verbosity = VERBOSITY_QUIET;
+        }
+        else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc)
+        {
+            runsPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--export-processes") == 0 && i + 1 < argc)
+        {
+            processesPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--write-trace") == 0 && i + 1 < argc)
+        {
+            writeTracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--deadline-factor") == 0 && i + 1 < argc)
+        {
+            config.deadlineFactor = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc)
+        {
+            config.quantum = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cfs-latency") == 0 && i + 1 < argc)
+        {
+            config.cfsLatency = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--predict-alpha") == 0 && i + 1 < argc)
+        {
+            config.predictionAlpha = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--select") == 0 && i + 1 < argc && strcmp(argv[i + 1], "heap") == 0)
+        {
+            config.selection = SELECT_HEAP;
+            i++;
+        }
+        else if (strcmp(argv[i], "--select") == 0 && i + 1 < argc && strcmp(argv[i + 1], "scan") == 0)
+        {
+            config.selection = SELECT_SCAN;
+            i++;
+        }
+        else if (strcmp(argv[i], "--select") == 0 && i + 1 < argc && strcmp(argv[i + 1], "auto") == 0)
+        {
+            config.selection = SELECT_AUTO;
+            i++;
+        }
+        else if (strcmp(argv[i], "--mlfq-quanta") == 0 && i + 1 < argc)
+        {
+            // Comma-separated quanta, from the top level down
+            char* cursor = argv[++i];
+            config.mlfq.levels = 0;
+            for (;;)
+            {
+                char* end;
+                long quantum = strtol(cursor, &end, 10);
+                if (end == cursor || quantum <= 0 || quantum > INT_MAX || config.mlfq.levels == MLFQ_MAX_LEVELS)
+                {
+                    fprintf(stderr, "--mlfq-quanta takes 1 to %d positive quanta separated by commas.\n", MLFQ_MAX_LEVELS);
+                    return EXIT_FAILURE;
+                }
+                config.mlfq.quanta[config.mlfq.levels++] = (int)quantum;
+                if (*end != ',')
+                {
+                    if (*end != '\0')
+                    {
+                        fprintf(stderr, "--mlfq-quanta takes 1 to %d positive quanta separated by commas.\n", MLFQ_MAX_LEVELS);
+                        return EXIT_FAILURE;
+                    }
+                    break;
+                }
+                cursor = end + 1;
+            }
+        }
+        else if (strcmp(argv[i], "--mlfq-boost") == 0 && i + 1 < argc)
+        {
+            config.mlfq.boostInterval = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc)
+        {
+            config.cpus = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--queues") == 0 && i + 1 < argc && strcmp(argv[i + 1], "global") == 0)
+        {
+            config.queueLayout = QUEUES_GLOBAL;
+            i++;
+        }
+        else if (strcmp(argv[i], "--queues") == 0 && i + 1 < argc && strcmp(argv[i + 1], "per-core") == 0)
+        {
+            config.queueLayout = QUEUES_PER_CORE;
+            i++;
+        }
+        else if (strcmp(argv[i], "--migration-cost") == 0 && i + 1 < argc)
+        {
+            config.migrationCost = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--switch-cost") == 0 && i + 1 < argc)
+        {
+            config.switchCost = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--io-mix") == 0 && i + 1 < argc)
+        {
+            config.ioPercent = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "csv") == 0)
+        {
+            exportFormat = EXPORT_CSV;
+            i++;
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc && strcmp(argv[i + 1], "jsonl") == 0)
+        {
+            exportFormat = EXPORT_JSONL;
+            i++;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--horizon <quanta>] [--trials <n>] [--ci-target <percent>] [--max-trials <n>] [--threads <n>]\n"
+                            "       [--seed <n>] [--verbosity <0-2> | --quiet]\n"
+                            "       [--export <file>] [--export-processes <file>] [--format csv|jsonl]\n"
+                            "       [--trace <file>] [--write-trace <file>] [--deadline-factor <n>] [--io-mix <percent>]\n"
+                            "       [--quantum <n>] [--cfs-latency <n>] [--predict-alpha <a>] [--select auto|heap|scan]\n"
+                            "       [--mlfq-quanta <q1,q2,...>] [--mlfq-boost <n>]\n"
+                            "       [--cpus <n>] [--queues global|per-core] [--migration-cost <n>] [--switch-cost <n>]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (config.horizon <= 0)
     {
-        dest[i] = source[i];
+        fprintf(stderr, "The horizon must be a positive number of quanta.\n");
+        return EXIT_FAILURE;
+    }
+    if (runs <= 0 || numThreads < 0)
+    {
+        fprintf(stderr, "The number of trials must be positive and the number of threads non-negative.\n");
+        return EXIT_FAILURE;
+    }
+    if (ciTarget < 0 || maxTrials < runs)
+    {
+        fprintf(stderr, "The CI target must be non-negative and the maximum number of trials at least the number of trials.\n");
+        return EXIT_FAILURE;
+    }
+    if (config.quantum <= 0 || config.cfsLatency <= 0 || config.mlfq.boostInterval < 0)
+    {
+        fprintf(stderr, "The quantum and CFS latency must be positive and the MLFQ boost interval non-negative.\n");
+        return EXIT_FAILURE;
+    }
+    if (config.cpus <= 0 || config.migrationCost < 0 || config.switchCost < 0)
+    {
+        fprintf(stderr, "The number of CPUs must be positive and the migration and switch costs non-negative.\n");
+        return EXIT_FAILURE;
+    }
+    if (config.deadlineFactor < 0 || config.deadlineFactor > MAX_DEADLINE_FACTOR)
+    {
+        fprintf(stderr, "The deadline factor must be between 0 and %d.\n", MAX_DEADLINE_FACTOR);
+        return EXIT_FAILURE;
+    }
+    if (!(config.predictionAlpha > 0 && config.predictionAlpha <= 1))
+    {
+        fprintf(stderr, "The prediction alpha must be greater than 0 and at most 1.\n");
+        return EXIT_FAILURE;
+    }
+    if (config.ioPercent < 0 || config.ioPercent > 100)
+    {
+        fprintf(stderr, "The I/O mix must be between 0 and 100 percent.\n");
+        return EXIT_FAILURE;
+    }
+    if (config.ioPercent > 0 && (tracePath != NULL || writeTracePath != NULL))
+    {
+        fprintf(stderr, "Traces carry no I/O bursts, so --io-mix cannot be combined with --trace or --write-trace.\n");
+        return EXIT_FAILURE;
+    }
+    if (config.verbosity < VERBOSITY_QUIET || config.verbosity > VERBOSITY_FULL)
+    {
+        fprintf(stderr, "The verbosity must be between %d and %d.\n", VERBOSITY_QUIET, VERBOSITY_FULL);
+        return EXIT_FAILURE;
     }
-}
 
-int main(int argc, char **argv)
-{
-	int numProcesses;
-    srand(time(NULL));
+    // Input: a trace to replay, or the number of processes to generate
+    if (tracePath != NULL)
+    {
+        // Every run maps the trace and reads its processes as they arrive, so a text trace is converted
+        // to binary once here rather than parsed again by every run
+        config.tracePath = prepareReplayTrace(tracePath);
+        numProcesses = countWorkload(config.tracePath);
+        // A trace is the same in every run and should be replayed to completion
+        if (!runsGiven)
+        {
+            runs = 1;
+        }
+        if (!horizonGiven)
+        {
+            config.horizon = NO_HORIZON;
+        }
+        printf("Trace: %s (%d processes, seed %llu)\n", tracePath, numProcesses, (unsigned long long)seed);
+    }
+    else
+    {
+        printf("Enter the number of processes to simulate: ");
+        if (scanf("%d", &numProcesses) != 1 || numProcesses <= 0)
+        {
+            fprintf(stderr, "The number of processes must be a positive integer.\n");
+            return EXIT_FAILURE;
+        }
+        printf("Seed: %llu\n", (unsigned long long)seed);
+    }
+    config.seed = seed; // Lottery scheduling draws from streams of the same seed
+    if (runsPath != NULL)
+    {
+        config.runSink = openResultSink(runsPath, exportFormat, EXPORT_RUNS);
+    }
+    if (processesPath != NULL)
+    {
+        config.processSink = openResultSink(processesPath, exportFormat, EXPORT_PROCESSES);
+    }
+    // Latency percentiles come from the distributions of every run merged per algorithm
+    config.latency = createLatencyReport(numSchedulers);
 
-    // Input: Number of processes
-    printf("Enter the number of processes to simulate: ");
-    scanf("%d", &numProcesses);
+    // Per-trial, per-algorithm results of a block of trials; results[i * numSchedulers + s] is algorithm s
+    // on run i of the block. The blocks are folded into per-algorithm statistics as they finish.
+    TrialResult* results = (TrialResult*)malloc(runs * numSchedulers * sizeof(TrialResult));
+    AlgorithmStats* stats = (AlgorithmStats*)calloc(numSchedulers, sizeof(AlgorithmStats));
+    if (results == NULL || stats == NULL)
+    {
+        fprintf(stderr, "Error allocating trial results!\n");
+        return EXIT_FAILURE;
+    }
 
-    int runs = 5;
-    // Arrays to store aggregated averages
-    float totalAvgTurnaroundTime[6], totalAvgWaitingTime[6], totalAvgResponseTime[6], totalThroughput[6];
-    for (int i = 0; i < 6; i++)
+    // Save the workload of the first run, e.g. to replay a generated workload or convert a text trace
+    if (writeTracePath != NULL)
+    {
+        if (tracePath != NULL)
+        {
+            convertTrace(tracePath, writeTracePath);
+        }
+        else
+        {
+            Rng rng;
+            rngStream(&rng, seed, 0);
+            Process* firstWorkload = (Process*)malloc(numProcesses * sizeof(Process));
+            generateProcesses(firstWorkload, numProcesses, config.horizon, config.deadlineFactor, config.ioPercent, &rng);
+            saveBinaryTrace(writeTracePath, firstWorkload, numProcesses);
+            free(firstWorkload);
+        }
+    }
+
+    // Measure where scanning stops paying off for --select auto while the machine is otherwise idle
+    if (config.selection == SELECT_AUTO)
     {
-    	totalAvgTurnaroundTime[i] = 0;
-    	totalAvgWaitingTime[i] = 0;
-    	totalAvgResponseTime[i] = 0;
-    	totalThroughput[i] = 0;
+        scanSelectMaxProcesses();
     }
-    for (int i = 0; i < runs; i++)
+
+    // Run the trials in blocks of --trials. With --ci-target, blocks are added until the target is
+    // reached; checking only between blocks keeps the number of trials the same with --threads.
+    if (numThreads > 0)
     {
-        printf("\nRUN %d:\n", i+1);
-        // Create and setup processes
-        Process* originalProcesses = (Process*)malloc(numProcesses * sizeof(Process));
-        generateProcesses(originalProcesses, numProcesses);
+        config.verbosity = VERBOSITY_QUIET;
+    }
+    int trialsRun = 0;
+    int targetReached = 0;
+    do
+    {
+        int block = (maxTrials - trialsRun < runs) ? maxTrials - trialsRun : runs;
+        if (numThreads > 0)
+        {
+            runTrialsParallel(trialsRun, block, numProcesses, &config, seed, numThreads, results);
+        }
+        else
+        {
+            for (int i = 0; i < block; i++)
+            {
+                int trial = trialsRun + i;
+                if (config.verbosity >= VERBOSITY_SUMMARY)
+                {
+                    printf("\nRUN %d:\n", trial + 1);
+                }
+                // Create and setup processes; run i always draws from stream i of the seed. A trace is
+                // read by every run itself, and once more here to be displayed.
+                Process* originalProcesses = NULL;
+                if (tracePath == NULL)
+                {
+                    originalProcesses = (Process*)malloc(numProcesses * sizeof(Process));
+                    Rng rng;
+                    rngStream(&rng, seed, trial);
+                    generateProcesses(originalProcesses, numProcesses, config.horizon, config.deadlineFactor, config.ioPercent, &rng);
+                }
 
-        // Display generated processes
-        printf("\nGenerated Processes:\n");
-        printf("Name\tArrival Time\tRun Time\tPriority\n");
-        for (int j = 0; j < numProcesses; j++) 
-        {
-            printf("%c\t%d\t\t%d\t\t%d\n", originalProcesses[j].name, originalProcesses[j].arrivalTime, originalProcesses[j].runtime, originalProcesses[j].priority);
-        }
-        float avgTurnaroundTime = 0, avgWaitingTime = 0, avgResponseTime = 0, throughput = 0;
-        // Run First Come First Serve scheduling
-        Process* fcfsProcesses = (Process*)malloc(numProcesses * sizeof(Process));
-        copyProcesses(fcfsProcesses, originalProcesses, numProcesses);
-        fcfs(fcfsProcesses, numProcesses, &avgTurnaroundTime, &avgWaitingTime, &avgResponseTime, &throughput);
-        totalAvgTurnaroundTime[0] += avgTurnaroundTime;
-        totalAvgWaitingTime[0] += avgWaitingTime;
-        totalAvgResponseTime[0] += avgResponseTime;
-        totalThroughput[0] += throughput;
-        free(fcfsProcesses);
-        printf("========================================================\n\n");
-        // Run Shortest Job First scheduling
-        avgTurnaroundTime = 0, avgWaitingTime = 0, avgResponseTime = 0, throughput = 0;
-        Process* sjfProcesses = (Process*)malloc(numProcesses * sizeof(Process));
-        copyProcesses(sjfProcesses, originalProcesses, numProcesses);
-        sjf(sjfProcesses, numProcesses, &avgTurnaroundTime, &avgWaitingTime, &avgResponseTime, &throughput);
-        totalAvgTurnaroundTime[1] += avgTurnaroundTime;
-        totalAvgWaitingTime[1] += avgWaitingTime;
-        totalAvgResponseTime[1] += avgResponseTime;
-        totalThroughput[1] += throughput;
-        free(sjfProcesses);
-        printf("========================================================\n\n");
-        // Run Shortest Remaining Time First scheduling
-        avgTurnaroundTime = 0, avgWaitingTime = 0, avgResponseTime = 0, throughput = 0;
-        Process* srtfProcesses = (Process*)malloc(numProcesses * sizeof(Process));
-        copyProcesses(srtfProcesses, originalProcesses, numProcesses);
-        srtf(srtfProcesses, numProcesses, &avgTurnaroundTime, &avgWaitingTime, &avgResponseTime, &throughput);
-        totalAvgTurnaroundTime[2] += avgTurnaroundTime;
-        totalAvgWaitingTime[2] += avgWaitingTime;
-        totalAvgResponseTime[2] += avgResponseTime;
-        totalThroughput[2] += throughput;
-        free(srtfProcesses);
-        printf("========================================================\n\n");
-        // Run Round Robin scheduling
-        avgTurnaroundTime = 0, avgWaitingTime = 0, avgResponseTime = 0, throughput = 0;
-        Process* rrProcesses = (Process*)malloc(numProcesses * sizeof(Process));
-        copyProcesses(rrProcesses, originalProcesses, numProcesses);
-        roundRobin(rrProcesses, numProcesses, &avgTurnaroundTime, &avgWaitingTime, &avgResponseTime, &throughput);
-        totalAvgTurnaroundTime[3] += avgTurnaroundTime;
-        totalAvgWaitingTime[3] += avgWaitingTime;
-        totalAvgResponseTime[3] += avgResponseTime;
-        totalThroughput[3] += throughput;
-        free(rrProcesses);
-        printf("========================================================\n\n");
-        // Run Highest Priority First scheduling in non-preemptive mode
-        avgTurnaroundTime = 0, avgWaitingTime = 0, avgResponseTime = 0, throughput = 0;
-        Process* hpfNPProcesses = (Process*)malloc(numProcesses * sizeof(Process));
-        copyProcesses(hpfNPProcesses, originalProcesses, numProcesses);
-        simulateHPFNonPreemptive(i+1, hpfNPProcesses, numProcesses, &avgTurnaroundTime, &avgWaitingTime, &avgResponseTime, &throughput);
-        totalAvgTurnaroundTime[4] += avgTurnaroundTime;
-        totalAvgWaitingTime[4] += avgWaitingTime;
-        totalAvgResponseTime[4] += avgResponseTime;
-        totalThroughput[4] += throughput;
-        free(hpfNPProcesses);
-        printf("========================================================\n\n");
-        // Run Highest Priority First scheduling in preemptive mode
-        avgTurnaroundTime = 0, avgWaitingTime = 0, avgResponseTime = 0, throughput = 0;
-        Process* hpfPreProcesses = (Process*)malloc(numProcesses * sizeof(Process));
-        copyProcesses(hpfPreProcesses, originalProcesses, numProcesses);
-        simulateHPFPreemptive(i+1, hpfPreProcesses, numProcesses, &avgTurnaroundTime, &avgWaitingTime, &avgResponseTime, &throughput);
-        totalAvgTurnaroundTime[5] += avgTurnaroundTime;
-        totalAvgWaitingTime[5] += avgWaitingTime;
-        totalAvgResponseTime[5] += avgResponseTime;
-        totalThroughput[5] += throughput;
-        free(hpfPreProcesses);
+                // Display generated processes
+                if (config.verbosity >= VERBOSITY_FULL)
+                {
+                    printf("\nGenerated Processes:\n");
+                    printf("Name\tArrival Time\tRun Time\tPriority\tDeadline%s\n", (config.ioPercent > 0) ? "\tCPU Bursts\tI/O Length" : "");
+                    WorkloadReader* reader = (tracePath != NULL) ? openWorkload(config.tracePath) : NULL;
+                    for (int j = 0; j < numProcesses; j++)
+                    {
+                        Process process;
+                        if (reader != NULL)
+                        {
+                            readNextProcess(reader, &process);
+                        }
+                        else
+                        {
+                            process = originalProcesses[j];
+                        }
+                        printf("P%d\t%d\t\t%d\t\t%d\t\t", process.pid, process.arrivalTime, process.runtime, process.priority);
+                        if (process.deadline == NO_DEADLINE)
+                        {
+                            printf("-");
+                        }
+                        else
+                        {
+                            printf("%d", process.deadline);
+                        }
+                        if (config.ioPercent > 0)
+                        {
+                            printf("\t\t%d\t\t%d", process.cpuBursts, process.ioLength);
+                        }
+                        printf("\n");
+                    }
+                    if (reader != NULL)
+                    {
+                        closeWorkload(reader);
+                    }
+                }
+                // Run every scheduling algorithm on its own copy of the processes
+                for (int s = 0; s < numSchedulers; s++)
+                {
+                    runScheduler(&schedulers[s], originalProcesses, numProcesses, &config, trial + 1, &results[i * numSchedulers + s]);
+                    if (config.verbosity >= VERBOSITY_SUMMARY)
+                    {
+                        printf("========================================================\n\n");
+                    }
+                }
+                // Free allocated memory
+                free(originalProcesses);
+                if (config.verbosity >= VERBOSITY_SUMMARY)
+                {
+                    printf("\n");
+                }
+            }
+        }
+
+
+        // Reduce in trial order so the statistics do not depend on how the runs were scheduled
+        for (int i = 0; i < block; i++)
+        {
+            for (int s = 0; s < numSchedulers; s++)
+            {
+                addTrialResult(&stats[s], &results[i * numSchedulers + s]);
+            }
+        }
+        trialsRun += block;
+        targetReached = ciTargetReached(stats, numSchedulers, ciTarget);
+    } while (ciTarget > 0 && !targetReached && trialsRun < maxTrials);
+
+    // Display the mean of every metric over all runs, with its spread once there is more than one
+    printf("\nFINAL AVERAGES AFTER %d RUNS:\n", trialsRun);
+    if (ciTarget > 0)
+    {
+        printf("The 95%% confidence intervals of the mean turnaround times %s within %.2f%% of the means after %d trials.\n",
+               targetReached ? "are" : "are not yet", ciTarget, trialsRun);
+    }
+    for (int s = 0; s < numSchedulers; s++)
+    {
+        printf("%s:\n", schedulers[s].name);
+        printStats(&stats[s].turnaround, "Average Turnaround Time", "");
+        printStats(&stats[s].waiting, "Average Waiting Time", "");
+        printStats(&stats[s].response, "Average Response Time", "");
+        printStats(&stats[s].throughput, "Average Throughput", " processes/unit time");
+        printStats(&stats[s].utilization, "Average CPU Utilization", "%");
+        printStats(&stats[s].contextSwitches, "Average Context Switches", "");
+        if (stats[s].missRate.count > 0)
+        {
+            printStats(&stats[s].missRate, "Average Deadline Miss Rate", "%");
+        }
+        if (stats[s].predictionError.count > 0)
+        {
+            printStats(&stats[s].predictionError, "Average Prediction Error", " quanta per burst");
+        }
+        // What not knowing the burst lengths costs: the gap to the algorithm that knows them
+        for (int o = 0; schedulers[s].oracle != NULL && o < numSchedulers; o++)
+        {
+            if (strcmp(schedulers[o].name, schedulers[s].oracle) == 0)
+            {
+                double turnaround = stats[s].turnaround.mean - stats[o].turnaround.mean;
+                double response = stats[s].response.mean - stats[o].response.mean;
+                printf("Penalty vs %s: Turnaround %+.2f (%+.2f%%), Response %+.2f (%+.2f%%)\n", schedulers[o].name,
+                       turnaround, (stats[o].turnaround.mean > 0) ? 100.0 * turnaround / stats[o].turnaround.mean : 0.0,
+                       response, (stats[o].response.mean > 0) ? 100.0 * response / stats[o].response.mean : 0.0);
+            }
+        }
+        const LatencyHistograms* latency = &config.latency->algorithms[s];
+        printHistogram(&latency->turnaround, "Turnaround Time");
+        printHistogram(&latency->waiting, "Waiting Time");
+        printHistogram(&latency->response, "Response Time");
         printf("========================================================\n\n");
-        // Free allocated memory
-        free(originalProcesses);
-        printf("\n");
-    }
-    // Calculate and display final averages over all runs
-    printf("\nFINAL AVERAGES AFTER %d RUNS:\n", runs);
-    printf("FCFS:\n");
-    printf("Average Turnaround Time: %.2f\n", totalAvgTurnaroundTime[0] / runs);
-    printf("Average Waiting Time: %.2f\n", totalAvgWaitingTime[0] / runs);
-    printf("Average Response Time: %.2f\n", totalAvgResponseTime[0] / runs);
-    printf("Average Throughput: %.2f processes/unit time\n", totalThroughput[0] / runs);
-    printf("========================================================\n\n");
-    printf("SJF:\n");
-    printf("Average Turnaround Time: %.2f\n", totalAvgTurnaroundTime[1] / runs);
-    printf("Average Waiting Time: %.2f\n", totalAvgWaitingTime[1] / runs);
-    printf("Average Response Time: %.2f\n", totalAvgResponseTime[1] / runs);
-    printf("Average Throughput: %.2f processes/unit time\n", totalThroughput[1] / runs);
-    printf("========================================================\n\n");
-    printf("SRTF:\n");
-    printf("Average Turnaround Time: %.2f\n", totalAvgTurnaroundTime[2] / runs);
-    printf("Average Waiting Time: %.2f\n", totalAvgWaitingTime[2] / runs);
-    printf("Average Response Time: %.2f\n", totalAvgResponseTime[2] / runs);
-    printf("Average Throughput: %.2f processes/unit time\n", totalThroughput[2] / runs);
-    printf("========================================================\n\n");
-    printf("RR:\n");
-    printf("Average Turnaround Time: %.2f\n", totalAvgTurnaroundTime[3] / runs);
-    printf("Average Waiting Time: %.2f\n", totalAvgWaitingTime[3] / runs);
-    printf("Average Response Time: %.2f\n", totalAvgResponseTime[3] / runs);
-    printf("Average Throughput: %.2f processes/unit time\n", totalThroughput[3] / runs);
-    printf("========================================================\n\n");
-    printf("HPF Non-Preemptive:\n");
-    printf("Average Turnaround Time: %.2f\n", totalAvgTurnaroundTime[4] / runs);
-    printf("Average Waiting Time: %.2f\n", totalAvgWaitingTime[4] / runs);
-    printf("Average Response Time: %.2f\n", totalAvgResponseTime[4] / runs);
-    printf("Average Throughput: %.2f processes/unit time\n", totalThroughput[4] / runs);
-    printf("========================================================\n\n");
-    printf("HPF Preemptive:\n");
-    printf("Average Turnaround Time: %.2f\n", totalAvgTurnaroundTime[5] / runs);
-    printf("Average Waiting Time: %.2f\n", totalAvgWaitingTime[5] / runs);
-    printf("Average Response Time: %.2f\n", totalAvgResponseTime[5] / runs);
-    printf("Average Throughput: %.2f processes/unit time\n", totalThroughput[5] / runs);
-    printf("========================================================\n\n");
+    }
+    if (config.runSink != NULL)
+    {
+        closeResultSink(config.runSink);
+    }
+    if (config.processSink != NULL)
+    {
+        closeResultSink(config.processSink);
+    }
+    freeLatencyReport(config.latency);
+    free(results);
+    free(stats);
+    freeRunArena();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "event_utils.h"
+#include "simulation.h"
+#include "arena_utils.h"
+
+// Charge a process at the given level for running span quanta and return the level it ends up in.
+// Every time it uses up the quantum of its level it moves down one level with a fresh quantum;
+// in the bottom level it just starts a fresh quantum.
+static int chargeQuanta(const MlfqConfig *mlfq, int level, int *used, int span)
+{
+    while (span > 0)
+    {
+        int left = mlfq->quanta[level] - *used;
+        if (span < left)
+        {
+            *used += span;
+            return level;
+        }
+        span -= left;
+        *used = 0;
+        if (level < mlfq->levels - 1)
+        {
+            level++;
+        }
+    }
+    return level;
+}
+
+// Queue a process that has arrived, or finished its I/O, at the top level. On its first arrival it
+// also joins the table.
+static void admit(ProcessTable *table, Process processes[], HandleQueue *top, int handle)
+{
+    if (handle == table->count)
+    {
+        addProcessTableRow(table, &processes[handle]);
+    }
+    enqueueHandle(top, handle);
+}
+
+// Multilevel feedback queue: new processes enter level 0, each level is Round Robin with its own
+// quantum, a process that uses up its quantum is demoted one level, and every boostInterval quanta
+// all processes are moved back to level 0. Processes in lower levels are preempted by arrivals. A process
+// that blocks for I/O comes back to level 0 with a fresh quantum when the I/O is done.
+void multilevelFeedbackQueue(Process processes[], int numProcesses, const SimConfig *config, RunResult *result)
+{
+    const MlfqConfig *mlfq = &config->mlfq;
+    ProcessTable *table = createProcessTable(numProcesses);
+    HandleQueue *queues[MLFQ_MAX_LEVELS];
+    for (int q = 0; q < mlfq->levels; q++)
+    {
+        queues[q] = createHandleQueue(numProcesses);
+    }
+    int *used = (int *)runCalloc(numProcesses, sizeof(int)); // Quanta used of the current level's quantum
+    if (used == NULL)
+    {
+        fprintf(stderr, "Error allocating MLFQ state!\n");
+        exit(EXIT_FAILURE);
+    }
+    Timeline *timeline = createTimeline(200);
+
+    int finished = 0;
+    int currentTime = 0;
+    int nextBoost = (mlfq->boostInterval > 0) ? mlfq->boostInterval : INT_MAX;
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
+
+    while (finished < numProcesses)
+    {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
+        {
+            result->stoppedAt = config->horizon;
+            break;
+        }
+
+        // Priority boost: every waiting process goes back to level 0, in level order, with a fresh quantum
+        if (currentTime >= nextBoost)
+        {
+            for (int q = 1; q < mlfq->levels; q++)
+            {
+                while (!isHandleQueueEmpty(queues[q]))
+                {
+                    enqueueHandle(queues[0], dequeueHandle(queues[q]));
+                }
+            }
+            for (int s = 0; s < queues[0]->size; s++)
+            {
+                used[handleAt(queues[0], s)] = 0;
+            }
+            nextBoost = currentTime - currentTime % mlfq->boostInterval + mlfq->boostInterval;
+        }
+
+        // New processes, and those that finished their I/O, enter the top level
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
+        {
+            admit(table, processes, queues[0], arrived);
+        }
+
+        // Choose the highest non-empty level
+        int level = -1;
+        for (int q = 0; q < mlfq->levels; q++)
+        {
+            if (!isHandleQueueEmpty(queues[q]))
+            {
+                level = q;
+                break;
+            }
+        }
+        if (level == -1)
+        {
+            // CPU is idle until the next arrival
+            currentTime = skipIdleTime(&arrivals, timeline, currentTime, config->horizon);
+            continue;
+        }
+
+        int handle = dequeueHandle(queues[level]);
+        result->decisions++;
+
+        // Run until the process finishes or its quantum expires. A process that is alone would be picked
+        // again after every quantum, so it keeps the CPU until it finishes or the next event instead.
+        // The CPU is also handed back at the next boost and at the horizon, and to arrivals when the
+        // process is below the top level. A context switch to the process delays the whole step.
+        int lone = allHandleQueuesEmpty(queues, mlfq->levels);
+        int runUntil = currentTime + table->remainingTime[handle];
+        if (!lone && runUntil > currentTime + mlfq->quanta[level] - used[handle])
+        {
+            runUntil = currentTime + mlfq->quanta[level] - used[handle];
+        }
+        if (runUntil > nextBoost)
+        {
+            runUntil = nextBoost;
+        }
+        if (runUntil > config->horizon)
+        {
+            runUntil = config->horizon;
+        }
+        if (lone || level > 0)
+        {
+            runUntil = nextEventTime(&arrivals, currentTime, runUntil);
+        }
+        int step = runUntil - currentTime;
+        currentTime = switchContext(timeline, currentTime, processes[handle].pid, config->switchCost);
+        if (table->startTime[handle] == -1)
+        {
+            table->startTime[handle] = currentTime;
+        }
+        updateTimeline(timeline, currentTime, step, processes[handle].pid);
+        table->remainingTime[handle] -= step;
+        currentTime += step;
+
+        // Processes that arrived while it ran queue up ahead of it
+        while ((arrived = nextArrival(&arrivals, currentTime - 1)) != -1)
+        {
+            admit(table, processes, queues[0], arrived);
+        }
+
+        if (table->remainingTime[handle] == 0)
+        {
+            // Finished, or blocked until its I/O is done
+            if (finishBurst(&arrivals, handle, currentTime))
+            {
+                table->completionTime[handle] = currentTime;
+                finished++;
+            }
+            else
+            {
+                table->remainingTime[handle] = processes[handle].remainingTime;
+                used[handle] = 0;
+            }
+        }
+        else
+        {
+            // Requeue it, one level down for every quantum it used up
+            enqueueHandle(queues[chargeQuanta(mlfq, level, &used[handle], step)], handle);
+        }
+    }
+
+    storeProcessTable(table, processes);
+    // Record every process that ran to completion
+    for (int i = 0; i < table->count; i++)
+    {
+        if (processes[i].completionTime != 0)
+        {
+            recordCompletion(result, &processes[i]);
+        }
+    }
+    finishRunResult(result, timeline); // The result takes over the timeline
+    for (int q = 0; q < mlfq->levels; q++)
+    {
+        freeHandleQueue(queues[q]);
+    }
+    freeProcessTable(table);
+    runFree(used);
+    freeArrivalCursor(&arrivals);
+}
@@ -0,0 +1,742 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "event_utils.h"
+#include "predict_utils.h"
+#include "simulation.h"
+#include "arena_utils.h"
+
+#define KEY_CLASS_SHIFT 40 // Keys made of a class and an enqueue order are (class << 40) + order
+
+// State of a multi-core run. Run queues are ready heaps of handles into the arrival-sorted
+// process array, ordered by the policy's key; FIFO policies key on the order processes were queued in.
+// Work stealing uses a handle deque per core instead, and lottery scheduling a ticket tree per queue.
+typedef struct Multicore {
+    int policy;             // One of the POLICY_* values
+    const SimConfig *config;
+    Process *processes;     // Processes of the run, indexed by handle
+    int numCores;           // Number of CPUs
+    int numQueues;          // 1 for a global run queue, numCores for per-core run queues
+    ReadyHeap **queues;     // Run queues (NULL under work stealing)
+    HandleQueue **deques;   // Per-core deques under work stealing, otherwise NULL
+    TicketTree **lotteries; // Per-queue ticket trees under lottery scheduling, otherwise NULL
+    Rng rng;                // Lottery draws
+    long long nextOrder;    // Enqueue counter
+    long long *order;       // order[handle] = enqueue counter value when it was last queued
+    int *level;             // level[handle] = MLFQ level
+    int *used;              // used[handle] = quanta used of the MLFQ level's quantum
+    long long *vruntime;    // vruntime[handle] = CFS virtual runtime, or stride pass
+    long long *minVruntime; // minVruntime[queue] = CFS virtual runtime (or stride pass) new processes in the queue start from
+    long long *queueWeight; // queueWeight[queue] = total CFS weight of the processes waiting in the queue
+    long long *levelTickets; // levelTickets[queue * NUM_PRIORITIES + p] = tickets of the runnable processes of priority p + 1
+    BurstPredictor *predictor; // Burst estimates under the predicted SJF and SRTF policies, otherwise NULL
+    int *lastCore;          // lastCore[handle] = CPU it last ran on, or -1
+    int *running;           // running[core] = handle on the CPU, or -1 if it is idle
+    int *switchEnd;         // switchEnd[core] = time the CPU has finished switching to the running process
+    int *runStart;          // runStart[core] = time the running process starts making progress (after a switch and migration)
+    int *sliceEnd;          // sliceEnd[core] = time its time slice expires, or INT_MAX
+    Timeline **timelines;   // timelines[core] = schedule of the CPU
+    double imbalanceArea;   // Sum over time of the gap between the most and least loaded core
+} Multicore;
+
+// Scheduling key of a process under the run's policy; smaller keys run first
+static long long policyKey(Multicore *mc, int handle)
+{
+    Process *process = &mc->processes[handle];
+    switch (mc->policy)
+    {
+    case POLICY_FCFS:
+        return mc->order[handle];
+    case POLICY_SJF:
+        return process->remainingTime;
+    case POLICY_SRTF:
+        return process->remainingTime;
+    case POLICY_SJF_PREDICTED:
+        return predictedBurst(mc->predictor, handle);
+    case POLICY_SRTF_PREDICTED:
+        return predictedRemaining(mc->predictor, handle);
+    case POLICY_RR:
+        return mc->order[handle];
+    case POLICY_HPF_NP:
+        return process->priority;
+    case POLICY_HPF_P:
+        return ((long long)process->priority << KEY_CLASS_SHIFT) + mc->order[handle];
+    case POLICY_CFS:
+    case POLICY_STRIDE:
+        return mc->vruntime[handle];
+    case POLICY_EDF:
+        return process->deadline;
+    case POLICY_LLF:
+        return (long long)process->deadline - remainingWork(process);
+    default:
+        return ((long long)mc->level[handle] << KEY_CLASS_SHIFT) + mc->order[handle];
+    }
+}
+
+// Check if a waiting process with a smaller key takes the CPU from a running one
+static int isPreemptive(int policy)
+{
+    return policy == POLICY_SRTF || policy == POLICY_SRTF_PREDICTED || policy == POLICY_HPF_P || policy == POLICY_MLFQ || policy == POLICY_CFS ||
+           policy == POLICY_EDF || policy == POLICY_LLF;
+}
+
+// How much smaller than the running process's key a waiting process's key must be to preempt it
+static long long preemptionMargin(int policy)
+{
+    return (policy == POLICY_CFS) ? CFS_WAKEUP_GRANULARITY : 0;
+}
+
+// Check if a process that started before the horizon may still run to completion, as in the
+// single-CPU FCFS and SJF; every other policy stops all CPUs at the horizon
+static int finishesPastHorizon(int policy)
+{
+    return policy == POLICY_FCFS || policy == POLICY_SJF || policy == POLICY_SJF_PREDICTED;
+}
+
+// Queue of a core: the global queue, or the core's own
+static int queueOfCore(Multicore *mc, int core)
+{
+    return (mc->numQueues == 1) ? 0 : core;
+}
+
+// Virtual time a process is charged for running a number of quanta: CFS virtual runtime, or stride pass
+static long long virtualTime(Multicore *mc, int handle, int quanta)
+{
+    int priority = mc->processes[handle].priority;
+    return (mc->policy == POLICY_STRIDE) ? strideLength(priority) * quanta : cfsVruntime(quanta, priority);
+}
+
+// Total CFS weight of the processes waiting in a queue and running on the cores it serves
+static long long runnableWeight(Multicore *mc, int queue)
+{
+    long long weight = mc->queueWeight[queue];
+    for (int c = 0; c < mc->numCores; c++)
+    {
+        if (mc->running[c] != -1 && queueOfCore(mc, c) == queue)
+        {
+            weight += cfsWeight(mc->processes[mc->running[c]].priority);
+        }
+    }
+    return weight;
+}
+
+// Length of the time slice a process gets when it is dispatched to a core, or INT_MAX if it runs until it finishes
+static int timeSlice(Multicore *mc, int core, int handle)
+{
+    switch (mc->policy)
+    {
+    case POLICY_RR:
+    case POLICY_WORK_STEALING:
+    case POLICY_LOTTERY:
+    case POLICY_STRIDE:
+        return mc->config->quantum;
+    case POLICY_HPF_P:
+    case POLICY_LLF: // Laxities change as processes run, so the choice is made again every quantum
+        return 1;
+    case POLICY_MLFQ:
+        return mc->config->mlfq.quanta[mc->level[handle]] - mc->used[handle];
+    case POLICY_CFS:
+        return cfsTimeSlice(mc->config, mc->processes[handle].priority, runnableWeight(mc, queueOfCore(mc, core)));
+    default:
+        return INT_MAX;
+    }
+}
+
+// Queue a process behind everything already queued with the same key (at the rear of a deque)
+static void enqueueReady(Multicore *mc, int queue, int handle)
+{
+    if (mc->deques != NULL)
+    {
+        enqueueHandle(mc->deques[queue], handle);
+        return;
+    }
+    if (mc->lotteries != NULL)
+    {
+        ticketTreeSet(mc->lotteries[queue], handle, lotteryTickets(mc->processes[handle].priority));
+        return;
+    }
+    mc->order[handle] = mc->nextOrder++;
+    if (mc->policy == POLICY_CFS)
+    {
+        // A process never comes back to a queue further behind than the queue's minimum virtual runtime
+        if (mc->vruntime[handle] < mc->minVruntime[queue])
+        {
+            mc->vruntime[handle] = mc->minVruntime[queue];
+        }
+        mc->queueWeight[queue] += cfsWeight(mc->processes[handle].priority);
+    }
+    heapInsert(mc->queues[queue], handle, policyKey(mc, handle));
+}
+
+// Number of processes waiting in a queue
+static int queueSize(Multicore *mc, int queue)
+{
+    if (mc->deques != NULL)
+    {
+        return mc->deques[queue]->size;
+    }
+    return (mc->lotteries != NULL) ? mc->lotteries[queue]->size : mc->queues[queue]->size;
+}
+
+// Queue a newly arrived process joins: the global queue, or that of the core with the least work.
+// Work stealing deals arrivals out by handle without looking at load and leaves balancing to the thieves.
+static int arrivalQueue(Multicore *mc, int handle)
+{
+    if (mc->deques != NULL)
+    {
+        return handle % mc->numCores;
+    }
+    int best = 0;
+    int bestLoad = INT_MAX;
+    for (int q = 0; q < mc->numQueues; q++)
+    {
+        int load = queueSize(mc, q) + (mc->running[q] != -1);
+        if (load < bestLoad)
+        {
+            best = q;
+            bestLoad = load;
+        }
+    }
+    return best;
+}
+
+// Give a core a process. Switching from another process first costs the switch time, and a process
+// that last ran on another core then costs the migration time.
+static void dispatch(Multicore *mc, int core, int handle, int currentTime, RunResult *result)
+{
+    Process *process = &mc->processes[handle];
+    int lastPid = mc->timelines[core]->lastPid;
+    result->decisions++;
+    mc->switchEnd[core] = currentTime;
+    if (lastPid != IDLE_PID && lastPid != process->pid)
+    {
+        mc->switchEnd[core] += mc->config->switchCost;
+    }
+    if (process->startTime == -1)
+    {
+        process->startTime = mc->switchEnd[core];
+    }
+    int stall = 0;
+    if (mc->lastCore[handle] != -1 && mc->lastCore[handle] != core)
+    {
+        stall = mc->config->migrationCost;
+        result->cores[core].migrations++;
+        result->cores[core].migrationTime += stall;
+    }
+    mc->lastCore[handle] = core;
+    mc->running[core] = handle;
+    mc->runStart[core] = mc->switchEnd[core] + stall;
+    int slice = timeSlice(mc, core, handle);
+    mc->sliceEnd[core] = (slice == INT_MAX) ? INT_MAX : mc->runStart[core] + slice;
+}
+
+// Take the running process off a core and queue it again. Under MLFQ it is charged for the
+// time it ran and moves down a level once it has used up its quantum.
+static void stopRunning(Multicore *mc, int core, int currentTime)
+{
+    int handle = mc->running[core];
+    if (mc->policy == POLICY_MLFQ && currentTime > mc->runStart[core])
+    {
+        mc->used[handle] += currentTime - mc->runStart[core];
+        if (mc->used[handle] >= mc->config->mlfq.quanta[mc->level[handle]])
+        {
+            mc->used[handle] = 0;
+            if (mc->level[handle] < mc->config->mlfq.levels - 1)
+            {
+                mc->level[handle]++;
+            }
+        }
+    }
+    mc->running[core] = -1;
+    enqueueReady(mc, queueOfCore(mc, core), handle);
+}
+
+// MLFQ priority boost: every process goes back to level 0 with a fresh quantum, keeping the level order
+static void boostAll(Multicore *mc, int currentTime, int *buffer)
+{
+    for (int c = 0; c < mc->numCores; c++)
+    {
+        if (mc->running[c] != -1)
+        {
+            stopRunning(mc, c, currentTime);
+        }
+    }
+    for (int q = 0; q < mc->numQueues; q++)
+    {
+        int count = 0;
+        while (!isHeapEmpty(mc->queues[q]))
+        {
+            buffer[count++] = heapPop(mc->queues[q]);
+        }
+        for (int i = 0; i < count; i++)
+        {
+            mc->level[buffer[i]] = 0;
+            mc->used[buffer[i]] = 0;
+            enqueueReady(mc, q, buffer[i]);
+        }
+    }
+}
+
+// Hand the processes waiting in a queue to the cores it serves: idle cores first, preferring the
+// core a process last ran on, then, under a preemptive policy, the core running the process with
+// the largest key for as long as a waiting process has a smaller one
+static void serveQueue(Multicore *mc, int queue, int currentTime, RunResult *result)
+{
+    ReadyHeap *ready = mc->queues[queue];
+    int first = (mc->numQueues == 1) ? 0 : queue;
+    int last = (mc->numQueues == 1) ? mc->numCores - 1 : queue;
+    while (!isHeapEmpty(ready))
+    {
+        int handle = heapPeek(ready);
+        int core = -1;
+        int previous = mc->lastCore[handle];
+        if (previous >= first && previous <= last && mc->running[previous] == -1)
+        {
+            core = previous;
+        }
+        for (int c = first; core == -1 && c <= last; c++)
+        {
+            if (mc->running[c] == -1)
+            {
+                core = c;
+            }
+        }
+        if (core == -1)
+        {
+            if (!isPreemptive(mc->policy))
+            {
+                return;
+            }
+            long long worst = -1;
+            for (int c = first; c <= last; c++)
+            {
+                long long key = policyKey(mc, mc->running[c]);
+                if (key > worst)
+                {
+                    worst = key;
+                    core = c;
+                }
+            }
+            if (ready->key[handle] + preemptionMargin(mc->policy) >= worst)
+            {
+                return;
+            }
+            stopRunning(mc, core, currentTime);
+        }
+        heapRemove(ready, handle);
+        if (mc->policy == POLICY_CFS)
+        {
+            mc->queueWeight[queue] -= cfsWeight(mc->processes[handle].priority);
+        }
+        dispatch(mc, core, handle, currentTime, result);
+    }
+}
+
+// Lottery scheduling: every idle core served by a queue runs the holder of a ticket drawn from the
+// queue, preferring the core the winner last ran on
+static void serveLottery(Multicore *mc, int queue, int currentTime, RunResult *result)
+{
+    TicketTree *tickets = mc->lotteries[queue];
+    int first = (mc->numQueues == 1) ? 0 : queue;
+    int last = (mc->numQueues == 1) ? mc->numCores - 1 : queue;
+    while (!isTicketTreeEmpty(tickets))
+    {
+        int core = -1;
+        for (int c = first; core == -1 && c <= last; c++)
+        {
+            if (mc->running[c] == -1)
+            {
+                core = c;
+            }
+        }
+        if (core == -1)
+        {
+            return;
+        }
+        int handle = drawLottery(tickets, &mc->rng);
+        int previous = mc->lastCore[handle];
+        if (previous >= first && previous <= last && mc->running[previous] == -1)
+        {
+            core = previous;
+        }
+        ticketTreeSet(tickets, handle, 0);
+        dispatch(mc, core, handle, currentTime, result);
+    }
+}
+
+// Work stealing: every idle core first takes the process at the front of its own deque; a core whose
+// deque is empty then steals the process at the rear of the fullest deque of another core
+static void serveDeques(Multicore *mc, int currentTime, RunResult *result)
+{
+    for (int c = 0; c < mc->numCores; c++)
+    {
+        if (mc->running[c] == -1 && !isHandleQueueEmpty(mc->deques[c]))
+        {
+            dispatch(mc, c, dequeueHandle(mc->deques[c]), currentTime, result);
+        }
+    }
+    for (int c = 0; c < mc->numCores; c++)
+    {
+        if (mc->running[c] != -1)
+        {
+            continue;
+        }
+        int victim = -1;
+        for (int v = 0; v < mc->numCores; v++)
+        {
+            if (v != c && mc->deques[v]->size > 0 && (victim == -1 || mc->deques[v]->size > mc->deques[victim]->size))
+            {
+                victim = v;
+            }
+        }
+        if (victim == -1)
+        {
+            return;
+        }
+        result->cores[c].steals++;
+        dispatch(mc, c, dequeueHandleBack(mc->deques[victim]), currentTime, result);
+    }
+}
+
+// Advance the minimum virtual runtime of each queue to the smallest virtual runtime of the processes
+// waiting in it and running on the cores it serves; it never decreases
+static void updateMinVruntime(Multicore *mc)
+{
+    for (int q = 0; q < mc->numQueues; q++)
+    {
+        long long smallest = isHeapEmpty(mc->queues[q]) ? -1 : mc->vruntime[heapPeek(mc->queues[q])];
+        for (int c = 0; c < mc->numCores; c++)
+        {
+            int handle = mc->running[c];
+            if (handle != -1 && queueOfCore(mc, c) == q && (smallest == -1 || mc->vruntime[handle] < smallest))
+            {
+                smallest = mc->vruntime[handle];
+            }
+        }
+        if (smallest > mc->minVruntime[q])
+        {
+            mc->minVruntime[q] = smallest;
+        }
+    }
+}
+
+// Split the progress the cores make over [currentTime, nextTime) by priority level, next to the share
+// the tickets of each queue's runnable processes entitle that level to
+static void accountShares(Multicore *mc, int currentTime, int nextTime, RunResult *result)
+{
+    for (int c = 0; c < mc->numCores; c++)
+    {
+        int handle = mc->running[c];
+        int progressFrom = (mc->runStart[c] > currentTime) ? mc->runStart[c] : currentTime;
+        if (handle != -1 && nextTime > progressFrom)
+        {
+            result->cpuTime[mc->processes[handle].priority - 1] += nextTime - progressFrom;
+            recordShares(result, &mc->levelTickets[queueOfCore(mc, c) * NUM_PRIORITIES], nextTime - progressFrom);
+        }
+    }
+}
+
+// Add the gap between the most and least loaded core over [currentTime, nextTime). A core's load is
+// its running process plus, with per-core queues, the processes waiting in its own queue.
+static void accountImbalance(Multicore *mc, int currentTime, int nextTime)
+{
+    int most = 0, least = INT_MAX;
+    for (int c = 0; c < mc->numCores; c++)
+    {
+        int load = (mc->running[c] != -1) + ((mc->numQueues > 1) ? queueSize(mc, c) : 0);
+        most = (load > most) ? load : most;
+        least = (load < least) ? load : least;
+    }
+    mc->imbalanceArea += (double)(most - least) * (nextTime - currentTime);
+}
+
+// Run the work-stealing policy: Round Robin with the configured quantum on a deque per CPU
+void workStealing(Process processes[], int numProcesses, const SimConfig *config, RunResult *result)
+{
+    runMulticore(POLICY_WORK_STEALING, processes, numProcesses, config, result);
+}
+
+// Simulate a policy on config->cpus CPUs with a global or per-core run queues. Time jumps from one
+// event (arrival, completion, expiring time slice, MLFQ boost) to the next, and every CPU records
+// its own timeline. Migrations cost config->migrationCost quanta on the CPU the process moves to, and
+// a CPU spends config->switchCost quanta switching to a different process than the one it last ran.
+// Unlike on one CPU, arrivals during a switch are handled as it happens and may preempt the process.
+void runMulticore(int policy, Process processes[], int numProcesses, const SimConfig *config, RunResult *result)
+{
+    Multicore mc;
+    mc.policy = policy;
+    mc.config = config;
+    mc.processes = processes;
+    mc.numCores = config->cpus;
+    mc.numQueues = (config->queueLayout == QUEUES_PER_CORE || policy == POLICY_WORK_STEALING) ? config->cpus : 1;
+    mc.nextOrder = 0;
+    mc.imbalanceArea = 0;
+    mc.queues = NULL;
+    mc.deques = NULL;
+    mc.lotteries = NULL;
+    mc.predictor = NULL;
+    if (policy == POLICY_SJF_PREDICTED || policy == POLICY_SRTF_PREDICTED)
+    {
+        mc.predictor = createBurstPredictor(numProcesses, config->predictionAlpha);
+    }
+    rngStream(&mc.rng, config->seed, LOTTERY_STREAM_BASE + config->trial);
+    if (policy == POLICY_WORK_STEALING)
+    {
+        mc.deques = (HandleQueue **)runAlloc(mc.numQueues * sizeof(HandleQueue *));
+    }
+    else if (policy == POLICY_LOTTERY)
+    {
+        mc.lotteries = (TicketTree **)runAlloc(mc.numQueues * sizeof(TicketTree *));
+    }
+    else
+    {
+        mc.queues = (ReadyHeap **)runAlloc(mc.numQueues * sizeof(ReadyHeap *));
+    }
+    mc.order = (long long *)runAlloc(numProcesses * sizeof(long long));
+    mc.level = (int *)runCalloc(numProcesses, sizeof(int));
+    mc.used = (int *)runCalloc(numProcesses, sizeof(int));
+    mc.vruntime = (long long *)runCalloc(numProcesses, sizeof(long long));
+    mc.minVruntime = (long long *)runCalloc(mc.numQueues, sizeof(long long));
+    mc.queueWeight = (long long *)runCalloc(mc.numQueues, sizeof(long long));
+    mc.levelTickets = (long long *)runCalloc(mc.numQueues * NUM_PRIORITIES, sizeof(long long));
+    mc.lastCore = (int *)runAlloc(numProcesses * sizeof(int));
+    mc.running = (int *)runAlloc(mc.numCores * sizeof(int));
+    mc.switchEnd = (int *)runAlloc(mc.numCores * sizeof(int));
+    mc.runStart = (int *)runAlloc(mc.numCores * sizeof(int));
+    mc.sliceEnd = (int *)runAlloc(mc.numCores * sizeof(int));
+    mc.timelines = (Timeline **)runAlloc(mc.numCores * sizeof(Timeline *));
+    int *buffer = (int *)runAlloc(numProcesses * sizeof(int)); // Scratch space for MLFQ boosts
+    if ((mc.queues == NULL && mc.deques == NULL && mc.lotteries == NULL) || mc.order == NULL || mc.level == NULL || mc.used == NULL || mc.vruntime == NULL ||
+        mc.minVruntime == NULL || mc.queueWeight == NULL || mc.levelTickets == NULL || mc.lastCore == NULL ||
+        mc.running == NULL || mc.switchEnd == NULL || mc.runStart == NULL || mc.sliceEnd == NULL || mc.timelines == NULL || buffer == NULL)
+    {
+        fprintf(stderr, "Error allocating multi-core state!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int q = 0; q < mc.numQueues; q++)
+    {
+        if (mc.deques != NULL)
+        {
+            mc.deques[q] = createHandleQueue(numProcesses);
+        }
+        else if (mc.lotteries != NULL)
+        {
+            mc.lotteries[q] = createTicketTree(numProcesses);
+        }
+        else if (policy == POLICY_SJF || policy == POLICY_SRTF)
+        {
+            mc.queues[q] = createShortestFirstHeap(config, numProcesses);
+        }
+        else
+        {
+            mc.queues[q] = createReadyHeap(numProcesses);
+        }
+    }
+    for (int i = 0; i < numProcesses; i++)
+    {
+        mc.lastCore[i] = -1;
+    }
+    for (int c = 0; c < mc.numCores; c++)
+    {
+        mc.running[c] = -1;
+        mc.timelines[c] = createTimeline(100);
+    }
+    initCoreResults(result, mc.numCores);
+    result->reportShares = (policy == POLICY_LOTTERY || policy == POLICY_STRIDE);
+    result->reportByPriority = (policy == POLICY_HPF_NP || policy == POLICY_HPF_P || result->reportShares);
+
+    int finished = 0;
+    int currentTime = 0;
+    int nextBoost = (policy == POLICY_MLFQ && config->mlfq.boostInterval > 0) ? config->mlfq.boostInterval : INT_MAX;
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
+
+    while (finished < numProcesses)
+    {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        int nextTime = INT_MAX;
+        if (currentTime >= config->horizon)
+        {
+            result->stoppedAt = config->horizon;
+            int busy = 0;
+            for (int c = 0; c < mc.numCores; c++)
+            {
+                busy |= (mc.running[c] != -1);
+            }
+            if (!finishesPastHorizon(policy) || !busy)
+            {
+                break;
+            }
+        }
+        else
+        {
+            if (currentTime >= nextBoost)
+            {
+                boostAll(&mc, currentTime, buffer);
+                nextBoost = currentTime - currentTime % config->mlfq.boostInterval + config->mlfq.boostInterval;
+            }
+
+            // Queue new arrivals and processes that finished their I/O, and fill (or preempt) the cores
+            int arrived;
+            while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
+            {
+                int queue = arrivalQueue(&mc, arrived);
+                int priority = processes[arrived].priority;
+                if (policy == POLICY_STRIDE)
+                {
+                    mc.vruntime[arrived] = mc.minVruntime[queue] + strideLength(priority);
+                }
+                mc.levelTickets[queue * NUM_PRIORITIES + priority - 1] += lotteryTickets(priority);
+                enqueueReady(&mc, queue, arrived);
+            }
+            if (mc.deques != NULL)
+            {
+                serveDeques(&mc, currentTime, result);
+            }
+            else if (mc.lotteries != NULL)
+            {
+                for (int q = 0; q < mc.numQueues; q++)
+                {
+                    serveLottery(&mc, q, currentTime, result);
+                }
+            }
+            else
+            {
+                for (int q = 0; q < mc.numQueues; q++)
+                {
+                    serveQueue(&mc, q, currentTime, result);
+                }
+            }
+            nextTime = nextEventTime(&arrivals, currentTime, nextBoost < config->horizon ? nextBoost : config->horizon);
+        }
+
+        // Nothing changes until the next arrival, boost, completion or expiring time slice
+        for (int c = 0; c < mc.numCores; c++)
+        {
+            if (mc.running[c] != -1)
+            {
+                int progressFrom = (mc.runStart[c] > currentTime) ? mc.runStart[c] : currentTime;
+                int finishTime = progressFrom + processes[mc.running[c]].remainingTime;
+                if (finishTime < nextTime)
+                {
+                    nextTime = finishTime;
+                }
+                if (mc.sliceEnd[c] < nextTime)
+                {
+                    nextTime = mc.sliceEnd[c];
+                }
+            }
+        }
+
+        accountImbalance(&mc, currentTime, nextTime);
+        accountShares(&mc, currentTime, nextTime, result);
+        for (int c = 0; c < mc.numCores; c++)
+        {
+            int handle = mc.running[c];
+            if (handle == -1)
+            {
+                updateTimeline(mc.timelines[c], currentTime, nextTime - currentTime, IDLE_PID);
+                continue;
+            }
+            int switchUntil = (mc.switchEnd[c] < nextTime) ? mc.switchEnd[c] : nextTime;
+            if (switchUntil > currentTime)
+            {
+                updateTimeline(mc.timelines[c], currentTime, switchUntil - currentTime, SWITCH_PID);
+            }
+            else
+            {
+                switchUntil = currentTime;
+            }
+            if (nextTime > switchUntil)
+            {
+                updateTimeline(mc.timelines[c], switchUntil, nextTime - switchUntil, processes[handle].pid);
+            }
+            int progressFrom = (mc.runStart[c] > currentTime) ? mc.runStart[c] : currentTime;
+            if (nextTime > progressFrom)
+            {
+                processes[handle].remainingTime -= nextTime - progressFrom;
+                mc.vruntime[handle] += virtualTime(&mc, handle, nextTime - progressFrom);
+                if (mc.predictor != NULL)
+                {
+                    chargeBurst(mc.predictor, handle, nextTime - progressFrom);
+                }
+            }
+            if (processes[handle].remainingTime == 0)
+            {
+                // Finished, or blocked until its I/O is done; under MLFQ it then comes back to level 0
+                mc.levelTickets[queueOfCore(&mc, c) * NUM_PRIORITIES + processes[handle].priority - 1] -= lotteryTickets(processes[handle].priority);
+                mc.running[c] = -1;
+                if (mc.predictor != NULL)
+                {
+                    endBurst(mc.predictor, handle);
+                }
+                if (finishBurst(&arrivals, handle, nextTime))
+                {
+                    processes[handle].completionTime = nextTime;
+                    recordCoreCompletion(result, c, &processes[handle]);
+                    finished++;
+                }
+                else
+                {
+                    mc.level[handle] = 0;
+                    mc.used[handle] = 0;
+                }
+            }
+            else if (nextTime >= mc.sliceEnd[c])
+            {
+                stopRunning(&mc, c, nextTime);
+            }
+        }
+        if (policy == POLICY_CFS || policy == POLICY_STRIDE)
+        {
+            updateMinVruntime(&mc);
+        }
+        currentTime = nextTime;
+    }
+
+    // Calculate per-core and aggregate metrics; the result takes over the timelines
+    result->loadImbalance = (currentTime > 0) ? mc.imbalanceArea / currentTime : 0;
+    if (mc.predictor != NULL)
+    {
+        recordPredictions(result, mc.predictor);
+        freeBurstPredictor(mc.predictor);
+    }
+    finishMulticoreResult(result, mc.timelines);
+
+    // Free allocated resources
+    for (int q = 0; q < mc.numQueues; q++)
+    {
+        if (mc.deques != NULL)
+        {
+            freeHandleQueue(mc.deques[q]);
+        }
+        else if (mc.lotteries != NULL)
+        {
+            freeTicketTree(mc.lotteries[q]);
+        }
+        else
+        {
+            freeReadyHeap(mc.queues[q]);
+        }
+    }
+    runFree(mc.queues);
+    runFree(mc.deques);
+    runFree(mc.lotteries);
+    runFree(mc.order);
+    runFree(mc.level);
+    runFree(mc.used);
+    runFree(mc.vruntime);
+    runFree(mc.minVruntime);
+    runFree(mc.queueWeight);
+    runFree(mc.levelTickets);
+    runFree(mc.lastCore);
+    runFree(mc.running);
+    runFree(mc.switchEnd);
+    runFree(mc.runStart);
+    runFree(mc.sliceEnd);
+    runFree(mc.timelines);
+    runFree(buffer);
+    freeArrivalCursor(&arrivals);
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "predict_utils.h"
+#include "arena_utils.h"
+
+// Create a predictor for numProcesses processes that have not arrived yet
+BurstPredictor* createBurstPredictor(int numProcesses, double alpha) {
+    BurstPredictor* predictor = (BurstPredictor*)runAlloc(sizeof(BurstPredictor));
+    if (predictor == NULL) {
+        fprintf(stderr, "Error allocating burst predictor!\n");
+        exit(EXIT_FAILURE);
+    }
+    predictor->alpha = alpha;
+    predictor->systemEstimate = (long long)INITIAL_BURST_ESTIMATE << PREDICTION_SHIFT;
+    predictor->estimate = (long long*)runAlloc(numProcesses * sizeof(long long));
+    predictor->elapsed = (int*)runCalloc(numProcesses, sizeof(int));
+    if (predictor->estimate == NULL || predictor->elapsed == NULL) {
+        fprintf(stderr, "Error allocating burst estimates!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < numProcesses; i++) {
+        predictor->estimate[i] = -1;
+    }
+    predictor->totalError = 0;
+    predictor->bursts = 0;
+    return predictor;
+}
+
+// Predicted length of a process's next burst, in 1/2^PREDICTION_SHIFT quanta. The first time a
+// process is asked about, it takes the average over all bursts seen so far.
+long long predictedBurst(BurstPredictor* predictor, int handle) {
+    if (predictor->estimate[handle] < 0) {
+        predictor->estimate[handle] = predictor->systemEstimate;
+    }
+    return predictor->estimate[handle];
+}
+
+// Predicted time left in a process's current burst: its estimate less the time it has run, but never
+// below 0 once it has outrun the estimate
+long long predictedRemaining(BurstPredictor* predictor, int handle) {
+    long long remaining = predictedBurst(predictor, handle) - ((long long)predictor->elapsed[handle] << PREDICTION_SHIFT);
+    return (remaining > 0) ? remaining : 0;
+}
+
+// Account for a process running quanta of its current burst
+void chargeBurst(BurstPredictor* predictor, int handle, int quanta) {
+    predictor->elapsed[handle] += quanta;
+}
+
+// A process's burst is over: record how far off its prediction was and fold the burst's length into
+// its own estimate and the system-wide one
+void endBurst(BurstPredictor* predictor, int handle) {
+    long long actual = (long long)predictor->elapsed[handle] << PREDICTION_SHIFT;
+    long long predicted = predictedBurst(predictor, handle);
+    predictor->totalError += fabs((double)(predicted - actual)) / (1 << PREDICTION_SHIFT);
+    predictor->bursts++;
+    predictor->estimate[handle] = llround(predictor->alpha * actual + (1 - predictor->alpha) * predicted);
+    predictor->systemEstimate = llround(predictor->alpha * actual + (1 - predictor->alpha) * predictor->systemEstimate);
+    predictor->elapsed[handle] = 0;
+}
+
+// Free a predictor
+void freeBurstPredictor(BurstPredictor* predictor) {
+    runFree(predictor->estimate);
+    runFree(predictor->elapsed);
+    runFree(predictor);
+}
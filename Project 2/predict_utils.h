@@ -0,0 +1,29 @@
+#ifndef PREDICT_UTILS_H
+#define PREDICT_UTILS_H
+
+#define PREDICTION_SHIFT 10          // Burst estimates are kept in 1/2^10 quanta, so they key ready heaps exactly
+#define DEFAULT_PREDICTION_ALPHA 0.5 // Weight of the latest burst in the exponential average
+#define INITIAL_BURST_ESTIMATE 5     // Estimate of the first burst, in quanta, before any burst has been seen
+
+// Predicts the length of each process's next CPU burst from its past bursts by exponential averaging:
+// after a burst of length t the estimate becomes alpha * t + (1 - alpha) * estimate. A process that has
+// not run yet starts from the same average taken over every burst seen so far, so schedulers using it
+// never look at a runtime a real kernel could not know.
+typedef struct BurstPredictor {
+    double alpha;             // Weight of the latest burst
+    long long systemEstimate; // Average over the bursts of all processes; the estimate a new process starts from
+    long long* estimate;      // estimate[handle] = predicted length of its next burst, or -1 before it first arrives
+    int* elapsed;             // elapsed[handle] = time it has run in its current burst
+    double totalError;        // Sum of |predicted - actual| over the bursts seen, in quanta
+    int bursts;               // Bursts seen
+} BurstPredictor;
+
+// Burst predictor utilities
+BurstPredictor* createBurstPredictor(int numProcesses, double alpha);
+long long predictedBurst(BurstPredictor* predictor, int handle);
+long long predictedRemaining(BurstPredictor* predictor, int handle);
+void chargeBurst(BurstPredictor* predictor, int handle, int quanta);
+void endBurst(BurstPredictor* predictor, int handle);
+void freeBurstPredictor(BurstPredictor* predictor);
+
+#endif
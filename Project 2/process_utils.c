@@ -2,36 +2,87 @@
 #include <stdlib.h>
 #include <string.h>
 #include "process_utils.h"
+#include "arena_utils.h"
 
-// Generate random processes
-void generateProcesses(Process* processes, int numProcesses) {
-    char processName = 'A';
-    // srand(0); // Fixed random seed for debugging consistency
+// Generate random processes arriving before the horizon. With a positive deadlineFactor every process
+// must also finish within 1 to deadlineFactor times its runtime (plus its I/O time) of arriving; with 0
+// it has no deadline. About ioPercent percent of the processes are I/O-bound: their runtime is split into
+// 2 to MAX_CPU_BURSTS CPU bursts with an I/O burst between each two.
+// The caller owns the generator, so concurrent trials never share (or race on) one.
+void generateProcesses(Process* processes, int numProcesses, int horizon, int deadlineFactor, int ioPercent, Rng* rng) {
     for (int i = 0; i < numProcesses; i++) {
-        processes[i].name = processName;
-        if (processName == 'Z')
-        {
-            processName = 'a' - 1;
-        }
-        processName++;
-        processes[i].arrivalTime = rand() % 100;       // Random arrival time (0–99)
-        processes[i].runtime = (rand() % 10) + 1;     // Random runtime (1–10)
-        processes[i].priority = (rand() % 4) + 1;     // Random priority (1–4)
+        processes[i].pid = i + 1;
+        processes[i].arrivalTime = rngRange(rng, horizon);  // Random arrival time (0 to horizon-1)
+        processes[i].runtime = rngRange(rng, 10) + 1;    // Random runtime (1–10)
+        processes[i].priority = rngRange(rng, 4) + 1;     // Random priority (1–4)
         processes[i].startTime = -1;                  // Not yet started
         processes[i].completionTime = 0;             // Not yet completed
         processes[i].remainingTime = processes[i].runtime;
+        processes[i].cpuBursts = 1;
+        processes[i].ioLength = 0;
+        processes[i].burst = 0;
 
         if (processes[i].runtime <= 0) 
         {
-            fprintf(stderr, "Invalid runtime for process %c\n", processes[i].name);
+            fprintf(stderr, "Invalid runtime for process P%d\n", processes[i].pid);
             exit(EXIT_FAILURE);
         }
     }
 
+    // Deadlines are drawn after everything else, so they never change the rest of the workload
+    for (int i = 0; i < numProcesses; i++) {
+        processes[i].deadline = NO_DEADLINE;
+        if (deadlineFactor > 0) {
+            int slack = rngRange(rng, processes[i].runtime * (deadlineFactor - 1) + 1);
+            processes[i].deadline = processes[i].arrivalTime + processes[i].runtime + slack;
+        }
+    }
+
+    // I/O bursts come last of all, so CPU-bound workloads are the same as before they existed
+    for (int i = 0; ioPercent > 0 && i < numProcesses; i++) {
+        if (rngRange(rng, 100) >= ioPercent || processes[i].runtime < 2) {
+            continue;
+        }
+        int cpuBursts = rngRange(rng, MAX_CPU_BURSTS - 1) + 2;
+        processes[i].cpuBursts = (cpuBursts < processes[i].runtime) ? cpuBursts : processes[i].runtime;
+        processes[i].ioLength = rngRange(rng, MAX_IO_LENGTH) + 1;
+        processes[i].remainingTime = cpuBurstLength(&processes[i], 0);
+        if (processes[i].deadline != NO_DEADLINE) {
+            processes[i].deadline += ioTime(&processes[i]);
+        }
+    }
+
     // Sort processes by arrival time
     qsort(processes, numProcesses, sizeof(Process), compareByArrivalTime);
 }
 
+// Length of a CPU burst of a process. The runtime is split as evenly as possible, earlier bursts taking the remainder.
+int cpuBurstLength(const Process* process, int burst) {
+    if (process->cpuBursts <= 1) {
+        return process->runtime;
+    }
+    return process->runtime / process->cpuBursts + (burst < process->runtime % process->cpuBursts);
+}
+
+// Total time a process spends blocked on I/O
+int ioTime(const Process* process) {
+    return (process->cpuBursts > 1) ? (process->cpuBursts - 1) * process->ioLength : 0;
+}
+
+// Time a process still needs to finish: the rest of its current CPU burst and all of its later I/O and CPU bursts
+int remainingWork(const Process* process) {
+    int work = process->remainingTime;
+    for (int burst = process->burst + 1; burst < process->cpuBursts; burst++) {
+        work += process->ioLength + cpuBurstLength(process, burst);
+    }
+    return work;
+}
+
+// Copy a generated workload so each algorithm schedules its own private array
+void copyProcesses(Process* dest, Process* source, int numProcesses) {
+    memcpy(dest, source, numProcesses * sizeof(Process));
+}
+
 // Comparison function for qsort (sort by arrival time)
 int compareByArrivalTime(const void* a, const void* b) {
     const Process* p1 = (const Process*)a;
@@ -39,62 +90,140 @@ int compareByArrivalTime(const void* a, const void* b) {
     return p1->arrivalTime - p2->arrivalTime;
 }
 
-// Create a new timeline
+// Create an empty struct-of-arrays table with room for numProcesses processes; handle i refers to processes[i]
+ProcessTable* createProcessTable(int numProcesses) {
+    ProcessTable* table = (ProcessTable*)runAlloc(sizeof(ProcessTable));
+    table->count = 0;
+    table->arrivalTime = (int*)runAlloc(numProcesses * sizeof(int));
+    table->runtime = (int*)runAlloc(numProcesses * sizeof(int));
+    table->priority = (int*)runAlloc(numProcesses * sizeof(int));
+    table->startTime = (int*)runAlloc(numProcesses * sizeof(int));
+    table->completionTime = (int*)runAlloc(numProcesses * sizeof(int));
+    table->remainingTime = (int*)runAlloc(numProcesses * sizeof(int));
+    return table;
+}
+
+// Copy a process into the table when it arrives for the first time. Processes first arrive in handle
+// order, so its row is the next one, and a trace only has to be read as far as the run gets.
+void addProcessTableRow(ProcessTable* table, const Process* process) {
+    int i = table->count++;
+    table->arrivalTime[i] = process->arrivalTime;
+    table->runtime[i] = process->runtime;
+    table->priority[i] = process->priority;
+    table->startTime[i] = process->startTime;
+    table->completionTime[i] = process->completionTime;
+    table->remainingTime[i] = process->remainingTime;
+}
+
+// Copy the scheduling results in a table back into the processes its rows came from
+void storeProcessTable(ProcessTable* table, Process* processes) {
+    for (int i = 0; i < table->count; i++) {
+        processes[i].startTime = table->startTime[i];
+        processes[i].completionTime = table->completionTime[i];
+        processes[i].remainingTime = table->remainingTime[i];
+    }
+}
+
+// Free process table memory
+void freeProcessTable(ProcessTable* table) {
+    runFree(table->arrivalTime);
+    runFree(table->runtime);
+    runFree(table->priority);
+    runFree(table->startTime);
+    runFree(table->completionTime);
+    runFree(table->remainingTime);
+    runFree(table);
+}
+
+// Create a new timeline with room for initialCapacity segments
 Timeline* createTimeline(int initialCapacity) {
-    Timeline* t = (Timeline*)malloc(sizeof(Timeline));
-    t->timeline = (char*)calloc(initialCapacity, sizeof(char));
+    Timeline* t = (Timeline*)runAlloc(sizeof(Timeline));
+    t->segments = (TimelineSegment*)runAlloc(initialCapacity * sizeof(TimelineSegment));
     t->capacity = initialCapacity;
+    t->count = 0;
     t->size = 0;
+    t->lastPid = IDLE_PID;
     return t;
 }
 
-// Resize the timeline if more capacity is needed
+// Resize the segment array if more capacity is needed
 void resizeTimeline(Timeline* t, int requiredCapacity) {
-    //printf("Resizing timeline: Current capacity = %d, Required capacity = %d\n", t->capacity, requiredCapacity);
     if (requiredCapacity > t->capacity) {
         if(requiredCapacity <= 0)
         {
             fprintf(stderr, "Invalid timeline capacity requested!\n");
             exit(EXIT_FAILURE);
         }
-        t->capacity = requiredCapacity * 2; // Double the capacity
-        t->timeline = (char*)realloc(t->timeline, t->capacity * sizeof(char));
-        if (!t->timeline) {
+        int newCapacity = t->capacity * 2; // Double the capacity
+        if (newCapacity < requiredCapacity) {
+            newCapacity = requiredCapacity;
+        }
+        t->segments = (TimelineSegment*)runRealloc(t->segments, t->capacity * sizeof(TimelineSegment), newCapacity * sizeof(TimelineSegment));
+        if (!t->segments) {
             fprintf(stderr, "Error reallocating timeline memory!\n");
             exit(EXIT_FAILURE);
         }
+        t->capacity = newCapacity;
     }
 }
 
-// Update the timeline with a process's execution
-void updateTimeline(Timeline* t, int startTime, int duration, char processName) {
+// Append a run of quanta to the end of the timeline
+static void appendSegment(Timeline* t, int startTime, int duration, int pid) {
+    if (pid != IDLE_PID && pid != SWITCH_PID) {
+        t->lastPid = pid;
+    }
+    // Extend the last segment when the same process keeps the CPU
+    if (t->count > 0) {
+        TimelineSegment* last = &t->segments[t->count - 1];
+        if (last->pid == pid && last->start + last->length == startTime) {
+            last->length += duration;
+            t->size = startTime + duration;
+            return;
+        }
+    }
+    resizeTimeline(t, t->count + 1);
+    t->segments[t->count].start = startTime;
+    t->segments[t->count].length = duration;
+    t->segments[t->count].pid = pid;
+    t->count++;
+    t->size = startTime + duration;
+}
+
+// Update the timeline with a process's execution. Updates must be appended in time order.
+void updateTimeline(Timeline* t, int startTime, int duration, int pid) {
      if (startTime < 0 || duration <= 0) {
         fprintf(stderr, "Invalid start time or duration in updateTimeline!\n");
         exit(EXIT_FAILURE);
     }
-    int endTime = startTime + duration;
-    resizeTimeline(t, endTime);
-
-    for (int i = startTime; i < endTime; i++) {
-        t->timeline[i] = processName;
+    if (startTime < t->size) {
+        fprintf(stderr, "Timeline update at %d overlaps the chart that ends at %d!\n", startTime, t->size);
+        exit(EXIT_FAILURE);
     }
-
-    if (endTime > t->size) {
-        t->size = endTime;
+    // Any quanta skipped over were idle
+    if (startTime > t->size) {
+        appendSegment(t, t->size, startTime - t->size, IDLE_PID);
     }
+    appendSegment(t, startTime, duration, pid);
 }
 
-// Print the timeline
+// Print the timeline one segment at a time, without expanding it to one slot per quantum
 void printTimeline(Timeline* t) {
-    printf("\nTime Chart (total %d quanta): ", t->size);
-    for (int i = 0; i < t->size; i++) {
-        printf("%c", t->timeline[i] ? t->timeline[i] : '-');
+    printf("\nTime Chart (total %d quanta, %d segments):", t->size, t->count);
+    for (int i = 0; i < t->count; i++) {
+        TimelineSegment* seg = &t->segments[i];
+        if (seg->pid == IDLE_PID) {
+            printf(" -[%d-%d)", seg->start, seg->start + seg->length);
+        } else if (seg->pid == SWITCH_PID) {
+            printf(" CS[%d-%d)", seg->start, seg->start + seg->length);
+        } else {
+            printf(" P%d[%d-%d)", seg->pid, seg->start, seg->start + seg->length);
+        }
     }
     printf("\n");
 }
 
 // Free timeline memory
 void freeTimeline(Timeline* t) {
-    free(t->timeline);
-    free(t);
+    runFree(t->segments);
+    runFree(t);
 }
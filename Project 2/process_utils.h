@@ -1,32 +1,77 @@
 #ifndef PROCESS_UTILS_H
 #define PROCESS_UTILS_H
 
+#include <limits.h>
+#include "rng_utils.h"
+
+#define NO_DEADLINE INT_MAX // Deadline of a process that has none
+#define MAX_CPU_BURSTS 4    // Most CPU bursts a generated process splits its runtime into
+#define MAX_IO_LENGTH 10    // Longest I/O burst of a generated process
+
 // Process structure
 typedef struct Process {
-    char name;         // Process name
+    int pid;           // Process ID
     int arrivalTime;   // Arrival time
     int runtime;       // Total runtime
     int priority;      // Priority level
+    int deadline;      // Time by which the process should have finished, or NO_DEADLINE
     int startTime;     // Time at which the process first gets the CPU
     int completionTime;// Time at which the process finishes execution
-    int remainingTime; // Time remaining for process to finish execution
+    int remainingTime; // Time remaining for process to finish its current CPU burst
+    int cpuBursts;     // CPU bursts the runtime is split into, with an I/O burst between each two (0 or 1 = CPU-bound)
+    int ioLength;      // Length of each I/O burst
+    int burst;         // Index of the current CPU burst
 } Process;
 
-// Timeline structure
+#define IDLE_PID -1    // Timeline pid for quanta where the CPU is idle
+#define SWITCH_PID -2  // Timeline pid for quanta the CPU spends switching between processes
+
+// Timeline segment: a run of consecutive quanta given to the same process
+typedef struct TimelineSegment {
+    int start;         // First quantum of the run
+    int length;        // Number of quanta in the run
+    int pid;           // Process that ran (IDLE_PID when the CPU was idle)
+} TimelineSegment;
+
+// Run-length encoded timeline: memory grows with the number of schedule changes, not with time
 typedef struct {
-    char* timeline;    // Dynamically allocated timeline
-    int capacity;      // Current capacity of the timeline
+    TimelineSegment* segments; // Dynamically allocated segments, in time order
+    int capacity;      // Current capacity of the segment array
+    int count;         // Number of segments in use
     int size;          // Current size of the timeline (used quanta)
+    int lastPid;       // Last process that ran, or IDLE_PID if none has yet
 } Timeline;
 
+// Struct-of-arrays process table. A process is referred to by its handle, which is its
+// index in the arrival-sorted process array, so lookups never have to search.
+typedef struct ProcessTable {
+    int count;           // Number of processes that have arrived (rows filled in)
+    int* arrivalTime;    // Arrival time per handle
+    int* runtime;        // Total runtime per handle
+    int* priority;       // Priority level per handle
+    int* startTime;      // First time on the CPU per handle (-1 if not started)
+    int* completionTime; // Completion time per handle (0 if not completed)
+    int* remainingTime;  // Remaining runtime per handle
+} ProcessTable;
+
 // Process-related utilities
-void generateProcesses(Process* processes, int numProcesses);
+void generateProcesses(Process* processes, int numProcesses, int horizon, int deadlineFactor, int ioPercent, Rng* rng);
+int cpuBurstLength(const Process* process, int burst);
+int ioTime(const Process* process);
+int remainingWork(const Process* process);
+void copyProcesses(Process* dest, Process* source, int numProcesses);
 int compareByArrivalTime(const void* a, const void* b);
 
+// Process table utilities
+ProcessTable* createProcessTable(int numProcesses);
+void addProcessTableRow(ProcessTable* table, const Process* process);
+void storeProcessTable(ProcessTable* table, Process* processes);
+void freeProcessTable(ProcessTable* table);
+
 // Timeline utilities
 Timeline* createTimeline(int initialCapacity);
 void resizeTimeline(Timeline* t, int requiredCapacity);
-void updateTimeline(Timeline* t, int startTime, int duration, char processName);
+void updateTimeline(Timeline* t, int startTime, int duration, int pid);
 void printTimeline(Timeline* t);
 void freeTimeline(Timeline* t);
 
@@ -1,54 +1,566 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include "queue_utils.h"
+#include "arena_utils.h"
 
-// Create a queue
-Queue* createQueue(int capacity) {
-    Queue* queue = (Queue*)malloc(sizeof(Queue));
+// Create a handle queue
+HandleQueue* createHandleQueue(int capacity) {
+    HandleQueue* queue = (HandleQueue*)runAlloc(sizeof(HandleQueue));
     queue->capacity = capacity;
     queue->front = 0;
     queue->rear = -1;
     queue->size = 0;
-    queue->processes = (Process*)malloc(capacity * sizeof(Process));
+    queue->handles = (int*)runAlloc(capacity * sizeof(int));
     return queue;
 }
 
-// Check if the queue is full
-int isQueueFull(Queue* queue) {
-    return queue->size == queue->capacity;
+// Check if the handle queue is empty
+int isHandleQueueEmpty(HandleQueue* queue) {
+    return queue->size == 0;
 }
 
-// Check if the queue is empty
-int isQueueEmpty(Queue* queue) {
-    return queue->size == 0;
+// Check if every queue in a multilevel set is empty
+int allHandleQueuesEmpty(HandleQueue* queues[], int numQueues) {
+    for (int i = 0; i < numQueues; i++) {
+        if (!isHandleQueueEmpty(queues[i])) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
-// Enqueue a process into the queue
-void enqueue(Queue* queue, Process process) {
-    if (isQueueFull(queue)) {
-        printf("Queue is full. Cannot enqueue process %c.\n", process.name);
+// Enqueue a handle into the queue
+void enqueueHandle(HandleQueue* queue, int handle) {
+    if (queue->size == queue->capacity) {
+        printf("Queue is full. Cannot enqueue handle %d.\n", handle);
         return;
     }
     queue->rear = (queue->rear + 1) % queue->capacity;
-    queue->processes[queue->rear] = process;
+    queue->handles[queue->rear] = handle;
     queue->size++;
 }
 
-// Dequeue a process from the queue
-Process dequeue(Queue* queue) {
-    if (isQueueEmpty(queue)) {
-        Process emptyProcess = {'\0', 0, 0, 0, -1, 0}; // Return an empty process
-        return emptyProcess;
+// Dequeue a handle from the queue, or return -1 if it is empty
+int dequeueHandle(HandleQueue* queue) {
+    if (isHandleQueueEmpty(queue)) {
+        return -1;
     }
-    Process process = queue->processes[queue->front];
+    int handle = queue->handles[queue->front];
     queue->front = (queue->front + 1) % queue->capacity;
     queue->size--;
-    return process;
+    return handle;
+}
+
+// Take a handle from the rear of the queue, or return -1 if it is empty. Together with
+// dequeueHandle() this makes a handle queue a deque: the owner works from the front and
+// thieves steal from the rear.
+int dequeueHandleBack(HandleQueue* queue) {
+    if (isHandleQueueEmpty(queue)) {
+        return -1;
+    }
+    int handle = queue->handles[queue->rear];
+    queue->rear = (queue->rear - 1 + queue->capacity) % queue->capacity;
+    queue->size--;
+    return handle;
+}
+
+// Return the handle at a position counted from the front, without removing it
+int handleAt(HandleQueue* queue, int position) {
+    return queue->handles[(queue->front + position) % queue->capacity];
+}
+
+// Free handle queue memory
+void freeHandleQueue(HandleQueue* queue) {
+    runFree(queue->handles);
+    runFree(queue);
+}
+
+// Create an empty ready heap for handles in [0, capacity)
+ReadyHeap* createReadyHeap(int capacity) {
+    ReadyHeap* heap = (ReadyHeap*)runAlloc(sizeof(ReadyHeap));
+    heap->heap = (int*)runAlloc(capacity * sizeof(int));
+    heap->position = (int*)runAlloc(capacity * sizeof(int));
+    heap->key = (long long*)runAlloc(capacity * sizeof(long long));
+    heap->slotKey = NULL;
+    heap->argmin = NULL;
+    heap->size = 0;
+    heap->capacity = capacity;
+    for (int i = 0; i < capacity; i++) {
+        heap->position[i] = -1;
+    }
+    return heap;
+}
+
+// Create an empty ready heap in the scan layout, for keys that fit in an int
+ReadyHeap* createScanHeap(int capacity) {
+    ReadyHeap* heap = createReadyHeap(capacity);
+    heap->slotKey = (int*)runAlloc(capacity * sizeof(int));
+    heap->argmin = bestArgminKernel();
+    return heap;
+}
+
+// Check if the heap is empty
+int isHeapEmpty(ReadyHeap* heap) {
+    return heap->size == 0;
+}
+
+// Check if a handle is currently queued
+int isInHeap(ReadyHeap* heap, int handle) {
+    return heap->position[handle] != -1;
+}
+
+// Strict ordering between two handles: smaller key first, then smaller handle
+static int heapLess(ReadyHeap* heap, int a, int b) {
+    if (heap->key[a] != heap->key[b]) {
+        return heap->key[a] < heap->key[b];
+    }
+    return a < b;
+}
+
+// Place a handle in a heap slot and record where it lives
+static void heapPlace(ReadyHeap* heap, int slot, int handle) {
+    heap->heap[slot] = handle;
+    heap->position[handle] = slot;
+}
+
+// Move the handle at slot towards the root until the heap property holds
+static void siftUp(ReadyHeap* heap, int slot) {
+    int handle = heap->heap[slot];
+    while (slot > 0) {
+        int parent = (slot - 1) / 2;
+        if (!heapLess(heap, handle, heap->heap[parent])) {
+            break;
+        }
+        heapPlace(heap, slot, heap->heap[parent]);
+        slot = parent;
+    }
+    heapPlace(heap, slot, handle);
+}
+
+// Move the handle at slot towards the leaves until the heap property holds
+static void siftDown(ReadyHeap* heap, int slot) {
+    int handle = heap->heap[slot];
+    for (;;) {
+        int child = 2 * slot + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && heapLess(heap, heap->heap[child + 1], heap->heap[child])) {
+            child++;
+        }
+        if (!heapLess(heap, heap->heap[child], handle)) {
+            break;
+        }
+        heapPlace(heap, slot, heap->heap[child]);
+        slot = child;
+    }
+    heapPlace(heap, slot, handle);
+}
+
+// Insert a handle with the given key
+void heapInsert(ReadyHeap* heap, int handle, long long key) {
+    if (heap->size == heap->capacity || isInHeap(heap, handle)) {
+        printf("Heap is full or already holds handle %d. Cannot insert.\n", handle);
+        return;
+    }
+    heap->key[handle] = key;
+    heapPlace(heap, heap->size, handle);
+    heap->size++;
+    if (heap->slotKey != NULL) {
+        if (key < INT_MIN || key > INT_MAX) {
+            fprintf(stderr, "Key %lld of handle %d does not fit a scan heap!\n", key, handle);
+            exit(EXIT_FAILURE);
+        }
+        heap->slotKey[heap->size - 1] = (int)key;
+        return;
+    }
+    siftUp(heap, heap->size - 1);
+}
+
+// Return the handle with the smallest key without removing it, or -1 if the heap is empty
+int heapPeek(ReadyHeap* heap) {
+    if (heap->slotKey != NULL) {
+        return heap->argmin(heap->slotKey, heap->heap, heap->size);
+    }
+    return isHeapEmpty(heap) ? -1 : heap->heap[0];
+}
+
+// Remove and return the handle with the smallest key, or -1 if the heap is empty
+int heapPop(ReadyHeap* heap) {
+    int top = heapPeek(heap);
+    if (top != -1) {
+        heapRemove(heap, top);
+    }
+    return top;
+}
+
+// Remove an arbitrary handle in O(log n), or O(1) in the scan layout
+void heapRemove(ReadyHeap* heap, int handle) {
+    int slot = heap->position[handle];
+    if (slot == -1) {
+        return;
+    }
+    heap->position[handle] = -1;
+    heap->size--;
+    if (slot == heap->size) {
+        return;
+    }
+    // Fill the hole with the last handle and restore the heap property in whichever direction it broke
+    int moved = heap->heap[heap->size];
+    heapPlace(heap, slot, moved);
+    if (heap->slotKey != NULL) {
+        heap->slotKey[slot] = heap->slotKey[heap->size];
+        return;
+    }
+    siftUp(heap, slot);
+    if (heap->position[moved] == slot) {
+        siftDown(heap, slot);
+    }
+}
+
+// Lower the key of a queued handle
+void heapDecreaseKey(ReadyHeap* heap, int handle, long long key) {
+    int slot = heap->position[handle];
+    if (slot == -1 || key > heap->key[handle]) {
+        printf("Invalid decrease-key for handle %d.\n", handle);
+        return;
+    }
+    heap->key[handle] = key;
+    if (heap->slotKey != NULL) {
+        heap->slotKey[slot] = (int)key;
+        return;
+    }
+    siftUp(heap, slot);
+}
+
+// Free heap memory
+void freeReadyHeap(ReadyHeap* heap) {
+    runFree(heap->heap);
+    runFree(heap->position);
+    runFree(heap->key);
+    runFree(heap->slotKey);
+    runFree(heap);
 }
 
-// Free queue memory
-void freeQueue(Queue* queue) {
-    free(queue->processes);
-    free(queue);
+// Create an empty run tree for handles in [0, capacity)
+RunTree* createRunTree(int capacity) {
+    RunTree* tree = (RunTree*)runAlloc(sizeof(RunTree));
+    tree->left = (int*)runAlloc(capacity * sizeof(int));
+    tree->right = (int*)runAlloc(capacity * sizeof(int));
+    tree->parent = (int*)runAlloc(capacity * sizeof(int));
+    tree->color = (char*)runCalloc(capacity, sizeof(char)); // Every handle starts as RB_NONE
+    tree->key = (long long*)runAlloc(capacity * sizeof(long long));
+    tree->root = -1;
+    tree->leftmost = -1;
+    tree->size = 0;
+    tree->capacity = capacity;
+    return tree;
 }
 
+// Check if the run tree is empty
+int isRunTreeEmpty(RunTree* tree) {
+    return tree->size == 0;
+}
+
+// Check if a handle is currently in the tree
+int isInRunTree(RunTree* tree, int handle) {
+    return tree->color[handle] != RB_NONE;
+}
+
+// Strict ordering between two handles: smaller key first, then smaller handle
+static int runTreeLess(RunTree* tree, int a, int b) {
+    if (tree->key[a] != tree->key[b]) {
+        return tree->key[a] < tree->key[b];
+    }
+    return a < b;
+}
+
+// A missing child counts as black
+static int isRed(RunTree* tree, int handle) {
+    return handle != -1 && tree->color[handle] == RB_RED;
+}
+
+// Replace the subtree rooted at u by the one rooted at v in u's parent
+static void replaceChild(RunTree* tree, int u, int v) {
+    int parent = tree->parent[u];
+    if (parent == -1) {
+        tree->root = v;
+    } else if (tree->left[parent] == u) {
+        tree->left[parent] = v;
+    } else {
+        tree->right[parent] = v;
+    }
+    if (v != -1) {
+        tree->parent[v] = parent;
+    }
+}
+
+// Rotate x down to the left: its right child takes its place
+static void rotateLeft(RunTree* tree, int x) {
+    int y = tree->right[x];
+    tree->right[x] = tree->left[y];
+    if (tree->left[y] != -1) {
+        tree->parent[tree->left[y]] = x;
+    }
+    replaceChild(tree, x, y);
+    tree->left[y] = x;
+    tree->parent[x] = y;
+}
+
+// Rotate x down to the right: its left child takes its place
+static void rotateRight(RunTree* tree, int x) {
+    int y = tree->left[x];
+    tree->left[x] = tree->right[y];
+    if (tree->right[y] != -1) {
+        tree->parent[tree->right[y]] = x;
+    }
+    replaceChild(tree, x, y);
+    tree->right[y] = x;
+    tree->parent[x] = y;
+}
+
+// Return the handle with the smallest key in the subtree rooted at handle
+static int subtreeMin(RunTree* tree, int handle) {
+    while (tree->left[handle] != -1) {
+        handle = tree->left[handle];
+    }
+    return handle;
+}
+
+// Insert a handle with the given key in O(log n)
+void runTreeInsert(RunTree* tree, int handle, long long key) {
+    if (tree->size == tree->capacity || isInRunTree(tree, handle)) {
+        printf("Run tree is full or already holds handle %d. Cannot insert.\n", handle);
+        return;
+    }
+    tree->key[handle] = key;
+    tree->left[handle] = -1;
+    tree->right[handle] = -1;
+    tree->color[handle] = RB_RED;
+
+    // Ordinary binary search tree insertion
+    int parent = -1;
+    int node = tree->root;
+    while (node != -1) {
+        parent = node;
+        node = runTreeLess(tree, handle, node) ? tree->left[node] : tree->right[node];
+    }
+    tree->parent[handle] = parent;
+    if (parent == -1) {
+        tree->root = handle;
+    } else if (runTreeLess(tree, handle, parent)) {
+        tree->left[parent] = handle;
+    } else {
+        tree->right[parent] = handle;
+    }
+    if (tree->leftmost == -1 || runTreeLess(tree, handle, tree->leftmost)) {
+        tree->leftmost = handle;
+    }
+    tree->size++;
+
+    // Restore the red-black properties: no red node has a red parent
+    node = handle;
+    while (isRed(tree, tree->parent[node])) {
+        parent = tree->parent[node];
+        int grandparent = tree->parent[parent];
+        int uncle = (parent == tree->left[grandparent]) ? tree->right[grandparent] : tree->left[grandparent];
+        if (isRed(tree, uncle)) {
+            tree->color[parent] = RB_BLACK;
+            tree->color[uncle] = RB_BLACK;
+            tree->color[grandparent] = RB_RED;
+            node = grandparent;
+        } else if (parent == tree->left[grandparent]) {
+            if (node == tree->right[parent]) {
+                node = parent;
+                rotateLeft(tree, node);
+                parent = tree->parent[node];
+            }
+            tree->color[parent] = RB_BLACK;
+            tree->color[grandparent] = RB_RED;
+            rotateRight(tree, grandparent);
+        } else {
+            if (node == tree->left[parent]) {
+                node = parent;
+                rotateRight(tree, node);
+                parent = tree->parent[node];
+            }
+            tree->color[parent] = RB_BLACK;
+            tree->color[grandparent] = RB_RED;
+            rotateLeft(tree, grandparent);
+        }
+    }
+    tree->color[tree->root] = RB_BLACK;
+}
+
+// Return the handle with the smallest key in O(1), or -1 if the tree is empty
+int runTreeMin(RunTree* tree) {
+    return tree->leftmost;
+}
+
+// Remove an arbitrary handle in O(log n)
+void runTreeRemove(RunTree* tree, int handle) {
+    if (!isInRunTree(tree, handle)) {
+        return;
+    }
+    if (tree->leftmost == handle) {
+        // The smallest handle has no left child, so its successor is below it on the right or its parent
+        tree->leftmost = (tree->right[handle] != -1) ? subtreeMin(tree, tree->right[handle]) : tree->parent[handle];
+    }
+
+    // x takes the place of the node that is spliced out; xParent is tracked since x may be missing
+    int removedColor = tree->color[handle];
+    int x, xParent;
+    if (tree->left[handle] == -1) {
+        x = tree->right[handle];
+        xParent = tree->parent[handle];
+        replaceChild(tree, handle, x);
+    } else if (tree->right[handle] == -1) {
+        x = tree->left[handle];
+        xParent = tree->parent[handle];
+        replaceChild(tree, handle, x);
+    } else {
+        int successor = subtreeMin(tree, tree->right[handle]);
+        removedColor = tree->color[successor];
+        x = tree->right[successor];
+        if (tree->parent[successor] == handle) {
+            xParent = successor;
+        } else {
+            xParent = tree->parent[successor];
+            replaceChild(tree, successor, x);
+            tree->right[successor] = tree->right[handle];
+            tree->parent[tree->right[successor]] = successor;
+        }
+        replaceChild(tree, handle, successor);
+        tree->left[successor] = tree->left[handle];
+        tree->parent[tree->left[successor]] = successor;
+        tree->color[successor] = tree->color[handle];
+    }
+    tree->color[handle] = RB_NONE;
+    tree->size--;
+
+    // Removing a black node leaves x one black short; push the deficit up or fix it by rotation
+    if (removedColor == RB_BLACK) {
+        while (x != tree->root && !isRed(tree, x)) {
+            if (x == tree->left[xParent]) {
+                int sibling = tree->right[xParent];
+                if (isRed(tree, sibling)) {
+                    tree->color[sibling] = RB_BLACK;
+                    tree->color[xParent] = RB_RED;
+                    rotateLeft(tree, xParent);
+                    sibling = tree->right[xParent];
+                }
+                if (!isRed(tree, tree->left[sibling]) && !isRed(tree, tree->right[sibling])) {
+                    tree->color[sibling] = RB_RED;
+                    x = xParent;
+                    xParent = tree->parent[x];
+                } else {
+                    if (!isRed(tree, tree->right[sibling])) {
+                        tree->color[tree->left[sibling]] = RB_BLACK;
+                        tree->color[sibling] = RB_RED;
+                        rotateRight(tree, sibling);
+                        sibling = tree->right[xParent];
+                    }
+                    tree->color[sibling] = tree->color[xParent];
+                    tree->color[xParent] = RB_BLACK;
+                    tree->color[tree->right[sibling]] = RB_BLACK;
+                    rotateLeft(tree, xParent);
+                    x = tree->root;
+                }
+            } else {
+                int sibling = tree->left[xParent];
+                if (isRed(tree, sibling)) {
+                    tree->color[sibling] = RB_BLACK;
+                    tree->color[xParent] = RB_RED;
+                    rotateRight(tree, xParent);
+                    sibling = tree->left[xParent];
+                }
+                if (!isRed(tree, tree->left[sibling]) && !isRed(tree, tree->right[sibling])) {
+                    tree->color[sibling] = RB_RED;
+                    x = xParent;
+                    xParent = tree->parent[x];
+                } else {
+                    if (!isRed(tree, tree->left[sibling])) {
+                        tree->color[tree->right[sibling]] = RB_BLACK;
+                        tree->color[sibling] = RB_RED;
+                        rotateLeft(tree, sibling);
+                        sibling = tree->left[xParent];
+                    }
+                    tree->color[sibling] = tree->color[xParent];
+                    tree->color[xParent] = RB_BLACK;
+                    tree->color[tree->left[sibling]] = RB_BLACK;
+                    rotateRight(tree, xParent);
+                    x = tree->root;
+                }
+            }
+        }
+        if (x != -1) {
+            tree->color[x] = RB_BLACK;
+        }
+    }
+}
+
+// Free run tree memory
+void freeRunTree(RunTree* tree) {
+    runFree(tree->left);
+    runFree(tree->right);
+    runFree(tree->parent);
+    runFree(tree->color);
+    runFree(tree->key);
+    runFree(tree);
+}
+
+// Create an empty ticket tree for handles in [0, capacity)
+TicketTree* createTicketTree(int capacity) {
+    TicketTree* tree = (TicketTree*)runAlloc(sizeof(TicketTree));
+    tree->sums = (long long*)runCalloc(capacity + 1, sizeof(long long));
+    tree->tickets = (int*)runCalloc(capacity, sizeof(int));
+    tree->total = 0;
+    tree->size = 0;
+    tree->capacity = capacity;
+    tree->topBit = 1;
+    while (tree->topBit * 2 <= capacity) {
+        tree->topBit *= 2;
+    }
+    return tree;
+}
+
+// Check if no handle holds tickets
+int isTicketTreeEmpty(TicketTree* tree) {
+    return tree->size == 0;
+}
+
+// Give a handle a number of tickets; 0 takes it out of the draw
+void ticketTreeSet(TicketTree* tree, int handle, int tickets) {
+    int delta = tickets - tree->tickets[handle];
+    if (delta == 0) {
+        return;
+    }
+    tree->size += (tickets > 0) - (tree->tickets[handle] > 0);
+    tree->tickets[handle] = tickets;
+    tree->total += delta;
+    for (int i = handle + 1; i <= tree->capacity; i += i & -i) {
+        tree->sums[i] += delta;
+    }
+}
+
+// Find the handle holding a ticket in [0, total): handles own consecutive ticket ranges in handle order,
+// so this is the first handle whose running ticket count exceeds the ticket
+int ticketTreeFind(TicketTree* tree, long long ticket) {
+    int position = 0;
+    for (int bit = tree->topBit; bit > 0; bit /= 2) {
+        int next = position + bit;
+        if (next <= tree->capacity && tree->sums[next] <= ticket) {
+            position = next;
+            ticket -= tree->sums[next];
+        }
+    }
+    return position; // Number of handles whose tickets all come before the ticket, i.e. the holder's handle
+}
+
+// Free ticket tree memory
+void freeTicketTree(TicketTree* tree) {
+    runFree(tree->sums);
+    runFree(tree->tickets);
+    runFree(tree);
+}
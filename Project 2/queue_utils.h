@@ -2,23 +2,98 @@
 #define QUEUE_UTILS_H
 
 #include "process_utils.h"
+#include "select_utils.h"
 
-// Queue structure
-typedef struct Queue {
-    Process* processes; // Array of processes
+// Circular queue of process handles (indices into a ProcessTable); also usable as a deque
+typedef struct HandleQueue {
+    int* handles;       // Array of handles
     int front;          // Front index
     int rear;           // Rear index
     int size;           // Current size
     int capacity;       // Maximum capacity
-} Queue;
-
-// Queue function prototypes
-Queue* createQueue(int capacity);
-int isQueueFull(Queue* queue);
-int isQueueEmpty(Queue* queue);
-void enqueue(Queue* queue, Process process);
-Process dequeue(Queue* queue);
-void freeQueue(Queue* queue);
+} HandleQueue;
+
+// Indexed binary min-heap of process handles (indices into the arrival-sorted process array).
+// Equal keys are ordered by handle, which for sorted processes means earliest arrival first.
+// A heap made by createScanHeap() keeps its handles unordered in slots 0 to size - 1 instead, with
+// their keys alongside in slotKey, and finds the smallest by scanning them: O(n), but a sequential
+// pass over two dense int arrays, which beats sifting for small ready sets.
+typedef struct ReadyHeap {
+    int* heap;          // Handles laid out as a binary min-heap (or unordered, in the scan layout)
+    int* position;      // position[handle] = slot in heap, or -1 if not queued
+    long long* key;     // key[handle] = scheduling key (e.g. remaining time)
+    int* slotKey;       // Scan layout only: slotKey[slot] = key of heap[slot]; NULL for a binary heap
+    ArgminKernel argmin; // Scan layout only: kernel that finds the smallest key, chosen for the CPU
+    int size;           // Current size
+    int capacity;       // Maximum number of handles
+} ReadyHeap;
+
+// Red-black tree of process handles ordered by key, then handle. Nodes are stored in arrays indexed
+// by handle, so a handle is removed without searching, and the leftmost handle is cached for O(1) min.
+typedef struct RunTree {
+    int* left;          // left[handle] = left child, or -1
+    int* right;         // right[handle] = right child, or -1
+    int* parent;        // parent[handle] = parent, or -1 for the root
+    char* color;        // color[handle] = RB_RED, RB_BLACK, or RB_NONE if the handle is not in the tree
+    long long* key;     // key[handle] = ordering key (e.g. virtual runtime)
+    int root;           // Root handle, or -1 if the tree is empty
+    int leftmost;       // Handle with the smallest key, or -1 if the tree is empty
+    int size;           // Current size
+    int capacity;       // Maximum number of handles
+} RunTree;
+
+#define RB_NONE 0
+#define RB_RED 1
+#define RB_BLACK 2
+
+// Fenwick (binary indexed) tree of the tickets held by process handles. Changing a handle's tickets and
+// finding the holder of a ticket both take O(log n), so a lottery draw stays cheap for large workloads.
+typedef struct TicketTree {
+    long long* sums;    // Fenwick partial sums over positions 1..capacity (position = handle + 1)
+    int* tickets;       // tickets[handle] = tickets held, or 0 if the handle is not in the draw
+    long long total;    // Tickets held by all handles
+    int size;           // Number of handles holding tickets
+    int capacity;       // Maximum number of handles
+    int topBit;         // Largest power of two not above capacity, where a search starts
+} TicketTree;
+
+// Handle queue function prototypes
+HandleQueue* createHandleQueue(int capacity);
+int isHandleQueueEmpty(HandleQueue* queue);
+int allHandleQueuesEmpty(HandleQueue* queues[], int numQueues);
+void enqueueHandle(HandleQueue* queue, int handle);
+int dequeueHandle(HandleQueue* queue);
+int dequeueHandleBack(HandleQueue* queue);
+int handleAt(HandleQueue* queue, int position);
+void freeHandleQueue(HandleQueue* queue);
+
+// Ready heap function prototypes
+ReadyHeap* createReadyHeap(int capacity);
+ReadyHeap* createScanHeap(int capacity);
+int isHeapEmpty(ReadyHeap* heap);
+int isInHeap(ReadyHeap* heap, int handle);
+void heapInsert(ReadyHeap* heap, int handle, long long key);
+int heapPeek(ReadyHeap* heap);
+int heapPop(ReadyHeap* heap);
+void heapRemove(ReadyHeap* heap, int handle);
+void heapDecreaseKey(ReadyHeap* heap, int handle, long long key);
+void freeReadyHeap(ReadyHeap* heap);
+
+// Run tree function prototypes
+RunTree* createRunTree(int capacity);
+int isRunTreeEmpty(RunTree* tree);
+int isInRunTree(RunTree* tree, int handle);
+void runTreeInsert(RunTree* tree, int handle, long long key);
+int runTreeMin(RunTree* tree);
+void runTreeRemove(RunTree* tree, int handle);
+void freeRunTree(RunTree* tree);
+
+// Ticket tree function prototypes
+TicketTree* createTicketTree(int capacity);
+int isTicketTreeEmpty(TicketTree* tree);
+void ticketTreeSet(TicketTree* tree, int handle, int tickets);
+int ticketTreeFind(TicketTree* tree, long long ticket);
+void freeTicketTree(TicketTree* tree);
 
 #endif
 
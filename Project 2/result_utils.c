@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "result_utils.h"
+#include "arena_utils.h"
+
+// Start an empty result. Per-process records and the timeline are only kept when detailed is set.
+void initRunResult(RunResult* result, int numProcesses, int detailed) {
+    memset(result, 0, sizeof(RunResult));
+    result->lateness = (int*)runAlloc(numProcesses * sizeof(int));
+    if (result->lateness == NULL) {
+        fprintf(stderr, "Error allocating lateness records!\n");
+        exit(EXIT_FAILURE);
+    }
+    if (detailed) {
+        result->records = (ProcessRecord*)runAlloc(numProcesses * sizeof(ProcessRecord));
+        if (result->records == NULL) {
+            fprintf(stderr, "Error allocating process records!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// Account for a finished process. Its waiting time is the time it spent ready but not running,
+// so time blocked on I/O is not counted.
+void recordCompletion(RunResult* result, const Process* process) {
+    int turnaroundTime = process->completionTime - process->arrivalTime;
+    int waitingTime = turnaroundTime - process->runtime - ioTime(process);
+    result->totalTurnaroundTime += turnaroundTime;
+    result->totalWaitingTime += waitingTime;
+    result->totalResponseTime += process->startTime - process->arrivalTime;
+    recordValue(&result->latency.turnaround, turnaroundTime);
+    recordValue(&result->latency.waiting, waitingTime);
+    recordValue(&result->latency.response, process->startTime - process->arrivalTime);
+    if (process->deadline != NO_DEADLINE) {
+        int lateness = process->completionTime - process->deadline;
+        result->lateness[result->deadlineProcesses++] = lateness;
+        result->deadlineMisses += (lateness > 0);
+    }
+    if (result->records != NULL) {
+        ProcessRecord* record = &result->records[result->completed];
+        record->pid = process->pid;
+        record->arrivalTime = process->arrivalTime;
+        record->runtime = process->runtime;
+        record->ioTime = ioTime(process);
+        record->priority = process->priority;
+        record->deadline = process->deadline;
+        record->startTime = process->startTime;
+        record->completionTime = process->completionTime;
+    }
+    result->completed++;
+}
+
+// Share out time the CPU was busy among the priority levels in proportion to the tickets their
+// runnable processes hold; this is what a perfectly fair proportional-share scheduler would give them
+void recordShares(RunResult* result, const long long tickets[], double time) {
+    long long total = 0;
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        total += tickets[p];
+    }
+    for (int p = 0; total > 0 && p < NUM_PRIORITIES; p++) {
+        result->entitledTime[p] += time * tickets[p] / total;
+    }
+}
+
+// Take over how many bursts a predictor saw and how far off its predictions were
+void recordPredictions(RunResult* result, const BurstPredictor* predictor) {
+    result->predictedBursts = predictor->bursts;
+    result->predictionError = (predictor->bursts > 0) ? predictor->totalError / predictor->bursts : 0;
+}
+
+// Count how often the CPU switched to a different process than the one that ran last.
+// Idle gaps are not switches, and neither is a process resuming after one. Time spent switching
+// is charged as its own segments and is not a process either.
+static int countContextSwitches(const Timeline* t) {
+    int switches = 0;
+    int last = IDLE_PID;
+    for (int i = 0; i < t->count; i++) {
+        int pid = t->segments[i].pid;
+        if (pid == IDLE_PID || pid == SWITCH_PID) {
+            continue;
+        }
+        if (last != IDLE_PID && pid != last) {
+            switches++;
+        }
+        last = pid;
+    }
+    return switches;
+}
+
+// Quanta of a timeline spent switching between processes
+static int countSwitchTime(const Timeline* t) {
+    int time = 0;
+    for (int i = 0; i < t->count; i++) {
+        if (t->segments[i].pid == SWITCH_PID) {
+            time += t->segments[i].length;
+        }
+    }
+    return time;
+}
+
+// Quanta of a timeline spent running processes: neither idle nor switching
+static int countRunTime(const Timeline* t) {
+    int time = 0;
+    for (int i = 0; i < t->count; i++) {
+        if (t->segments[i].pid != IDLE_PID && t->segments[i].pid != SWITCH_PID) {
+            time += t->segments[i].length;
+        }
+    }
+    return time;
+}
+
+static int compareInts(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Lateness at a whole percentile (nearest rank) of the sorted lateness records
+static int latenessPercentile(const RunResult* result, int percent) {
+    long long rank = ((long long)percent * result->deadlineProcesses + 99) / 100;
+    return result->lateness[(rank > 0 ? rank : 1) - 1];
+}
+
+// Compute the deadline miss rate and lateness percentiles over the finished processes that had a deadline
+static void computeLateness(RunResult* result) {
+    if (result->deadlineProcesses == 0) {
+        return;
+    }
+    qsort(result->lateness, result->deadlineProcesses, sizeof(int), compareInts);
+    result->missRate = (float)result->deadlineMisses / result->deadlineProcesses;
+    result->latenessP50 = latenessPercentile(result, 50);
+    result->latenessP90 = latenessPercentile(result, 90);
+    result->latenessP99 = latenessPercentile(result, 99);
+    result->latenessMax = result->lateness[result->deadlineProcesses - 1];
+}
+
+// Compute the averages over the finished processes
+static void computeAverages(RunResult* result) {
+    computeLateness(result);
+    if (result->completed > 0) {
+        result->avgTurnaroundTime = result->totalTurnaroundTime / result->completed;
+        result->avgWaitingTime = result->totalWaitingTime / result->completed;
+        result->avgResponseTime = result->totalResponseTime / result->completed;
+        result->throughput = (float)result->completed / result->totalTime;
+    }
+    if (result->totalTime > 0) {
+        result->utilization = (float)result->runTime / ((long long)result->totalTime * (result->numCores > 0 ? result->numCores : 1));
+    }
+}
+
+// Compute the averages once the run is over. Takes ownership of the timeline: it is kept
+// for printing when the result is detailed and freed otherwise.
+void finishRunResult(RunResult* result, Timeline* t) {
+    result->totalTime = t->size;
+    result->contextSwitches = countContextSwitches(t);
+    result->switchTime = countSwitchTime(t);
+    result->runTime = countRunTime(t);
+    computeAverages(result);
+    if (result->records != NULL) {
+        result->timeline = t;
+    } else {
+        freeTimeline(t);
+    }
+}
+
+// Start the per-core results of a multi-core run
+void initCoreResults(RunResult* result, int numCores) {
+    result->numCores = numCores;
+    result->cores = (CoreResult*)runCalloc(numCores, sizeof(CoreResult));
+    if (result->cores == NULL) {
+        fprintf(stderr, "Error allocating core results!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Account for a process that finished on the given core
+void recordCoreCompletion(RunResult* result, int core, const Process* process) {
+    CoreResult* coreResult = &result->cores[core];
+    int turnaroundTime = process->completionTime - process->arrivalTime;
+    coreResult->totalTurnaroundTime += turnaroundTime;
+    coreResult->totalWaitingTime += turnaroundTime - process->runtime - ioTime(process);
+    coreResult->totalResponseTime += process->startTime - process->arrivalTime;
+    coreResult->completed++;
+    recordCompletion(result, process);
+}
+
+// Compute the per-core and aggregate metrics once a multi-core run is over. Every core's timeline
+// covers the whole run; like finishRunResult(), this takes ownership of the timelines.
+void finishMulticoreResult(RunResult* result, Timeline* timelines[]) {
+    result->totalTime = timelines[0]->size;
+    result->contextSwitches = 0;
+    result->switchTime = 0;
+    result->runTime = 0;
+    for (int c = 0; c < result->numCores; c++) {
+        CoreResult* core = &result->cores[c];
+        core->contextSwitches = countContextSwitches(timelines[c]);
+        core->busyTime = 0;
+        for (int i = 0; i < timelines[c]->count; i++) {
+            if (timelines[c]->segments[i].pid != IDLE_PID) {
+                core->busyTime += timelines[c]->segments[i].length;
+            }
+        }
+        result->contextSwitches += core->contextSwitches;
+        result->switchTime += countSwitchTime(timelines[c]);
+        result->runTime += countRunTime(timelines[c]);
+        if (result->records != NULL) {
+            core->timeline = timelines[c];
+        } else {
+            freeTimeline(timelines[c]);
+        }
+    }
+    computeAverages(result);
+}
+
+// Print the metrics of every core of a multi-core run
+static void printCoreStats(const RunResult* result) {
+    printf("\nPer-core stats:\n");
+    for (int c = 0; c < result->numCores; c++) {
+        const CoreResult* core = &result->cores[c];
+        printf("CPU %d: Throughput=%.5f, Utilization=%.1f%%, Context Switches=%d, Migrations=%d (%d quanta), Steals=%d\n",
+               c, result->totalTime > 0 ? (float)core->completed / result->totalTime : 0.0f,
+               result->totalTime > 0 ? 100.0 * core->busyTime / result->totalTime : 0.0,
+               core->contextSwitches, core->migrations, core->migrationTime, core->steals);
+        if (core->completed > 0) {
+            printf("  Finished=%d, Avg Turnaround=%.2f, Avg Waiting=%.2f, Avg Response=%.2f\n", core->completed,
+                   core->totalTurnaroundTime / core->completed, core->totalWaitingTime / core->completed,
+                   core->totalResponseTime / core->completed);
+        } else {
+            printf("  Finished=0\n");
+        }
+    }
+}
+
+// Print the averages of each priority level from the per-process records
+static void printPriorityStats(const RunResult* result) {
+    double sumTurnaround[NUM_PRIORITIES] = {0};
+    double sumWaiting[NUM_PRIORITIES] = {0};
+    double sumResponse[NUM_PRIORITIES] = {0};
+    int count[NUM_PRIORITIES] = {0};
+
+    for (int i = 0; i < result->completed; i++) {
+        const ProcessRecord* record = &result->records[i];
+        int p = record->priority - 1;
+        int turnaround = record->completionTime - record->arrivalTime;
+        sumTurnaround[p] += turnaround;
+        sumWaiting[p] += turnaround - record->runtime - record->ioTime;
+        sumResponse[p] += record->startTime - record->arrivalTime;
+        count[p]++;
+    }
+
+    double totalCpuTime = 0, totalEntitledTime = 0, deviation = 0;
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        totalCpuTime += result->cpuTime[p];
+        totalEntitledTime += result->entitledTime[p];
+    }
+
+    printf("\nPer-priority stats:\n");
+    for (int p = 0; p < NUM_PRIORITIES; p++) {
+        if (count[p] > 0) {
+            printf("Priority %d: Throughput=%.5f\n", p + 1, (float)count[p] / result->totalTime);
+            printf("  Avg Turnaround=%.2f, Avg Waiting=%.2f, Avg Response=%.2f\n",
+                   sumTurnaround[p] / count[p], sumWaiting[p] / count[p], sumResponse[p] / count[p]);
+        } else {
+            printf("Priority %d: Throughput=0 (no processes finished)\n", p + 1);
+        }
+        if (result->reportShares && totalCpuTime > 0) {
+            double share = 100.0 * result->cpuTime[p] / totalCpuTime;
+            double target = 100.0 * result->entitledTime[p] / totalEntitledTime;
+            printf("  CPU Share=%.2f%% (target %.2f%%)\n", share, target);
+            double gap = (share > target) ? share - target : target - share;
+            if (gap > deviation) {
+                deviation = gap;
+            }
+        }
+    }
+    if (result->reportShares && totalCpuTime > 0) {
+        printf("Largest Share Deviation: %.2f%%\n", deviation);
+    }
+}
+
+// Print a finished run: per-process results and the time chart when the result is detailed,
+// followed by the averages
+void printRunResult(const RunResult* result, const char* title) {
+    printf("\n%s:\n", title);
+    if (result->records != NULL) {
+        for (int i = 0; i < result->completed; i++) {
+            const ProcessRecord* record = &result->records[i];
+            int turnaroundTime = record->completionTime - record->arrivalTime;
+            printf("Process P%d: Arrival Time = %d, Runtime = %d, Turnaround Time = %d, Waiting Time = %d, Response Time = %d\n",
+                   record->pid, record->arrivalTime, record->runtime, turnaroundTime,
+                   turnaroundTime - record->runtime - record->ioTime, record->startTime - record->arrivalTime);
+        }
+    }
+    if (result->stoppedAt > 0) {
+        printf("Stopping simulation since a process cannot be executed at or beyond quantum %d.\n", result->stoppedAt);
+    }
+    if (result->timeline != NULL) {
+        printTimeline(result->timeline);
+    }
+    for (int c = 0; c < result->numCores; c++) {
+        if (result->cores[c].timeline != NULL) {
+            printf("\nCPU %d:", c);
+            printTimeline(result->cores[c].timeline);
+        }
+    }
+    if (result->reportByPriority && result->records != NULL) {
+        printPriorityStats(result);
+    }
+    if (result->cores != NULL) {
+        printCoreStats(result);
+    }
+
+    printf("\nAverage Turnaround Time: %.2f\n", result->avgTurnaroundTime);
+    printf("Average Waiting Time: %.2f\n", result->avgWaitingTime);
+    printf("Average Response Time: %.2f\n", result->avgResponseTime);
+    printf("Throughput: %.2f processes/unit time\n", result->throughput);
+    printf("CPU Utilization: %.2f%%\n", 100.0 * result->utilization);
+    printf("Context Switches: %d\n", result->contextSwitches);
+    if (result->predictedBursts > 0) {
+        printf("Prediction Error: %.2f quanta per burst over %d bursts\n", result->predictionError, result->predictedBursts);
+    }
+    if (result->switchTime > 0) {
+        int cpuTime = result->totalTime * (result->numCores > 0 ? result->numCores : 1);
+        printf("Switch Overhead: %d quanta (%.2f%% of CPU time)\n", result->switchTime, 100.0 * result->switchTime / cpuTime);
+    }
+    if (result->deadlineProcesses > 0) {
+        printf("Deadline Misses: %d of %d (%.2f%%)\n", result->deadlineMisses, result->deadlineProcesses, 100.0 * result->missRate);
+        printf("Lateness: p50=%d, p90=%d, p99=%d, max=%d\n",
+               result->latenessP50, result->latenessP90, result->latenessP99, result->latenessMax);
+    }
+    if (result->cores != NULL) {
+        int migrations = 0, steals = 0;
+        for (int c = 0; c < result->numCores; c++) {
+            migrations += result->cores[c].migrations;
+            steals += result->cores[c].steals;
+        }
+        printf("Migrations: %d\n", migrations);
+        printf("Steals: %d\n", steals);
+        printf("Load Imbalance: %.2f processes\n", result->loadImbalance);
+    }
+}
+
+// Free the records, lateness records, timelines and per-core results kept by a result
+void freeRunResult(RunResult* result) {
+    runFree(result->records);
+    runFree(result->lateness);
+    if (result->timeline != NULL) {
+        freeTimeline(result->timeline);
+    }
+    for (int c = 0; c < result->numCores; c++) {
+        if (result->cores[c].timeline != NULL) {
+            freeTimeline(result->cores[c].timeline);
+        }
+    }
+    runFree(result->cores);
+    result->records = NULL;
+    result->lateness = NULL;
+    result->timeline = NULL;
+    result->cores = NULL;
+    result->numCores = 0;
+}
+
+// Create a latency report with empty distributions for numAlgorithms algorithms
+LatencyReport* createLatencyReport(int numAlgorithms) {
+    LatencyReport* report = (LatencyReport*)malloc(sizeof(LatencyReport));
+    if (report == NULL) {
+        fprintf(stderr, "Error allocating latency report!\n");
+        exit(EXIT_FAILURE);
+    }
+    report->numAlgorithms = numAlgorithms;
+    report->algorithms = (LatencyHistograms*)calloc(numAlgorithms, sizeof(LatencyHistograms));
+    if (report->algorithms == NULL) {
+        fprintf(stderr, "Error allocating latency histograms!\n");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_init(&report->lock, NULL);
+    return report;
+}
+
+// Add the distributions of a finished run to those of its algorithm
+void mergeLatencyReport(LatencyReport* report, int algorithm, const RunResult* result) {
+    LatencyHistograms* merged = &report->algorithms[algorithm];
+    pthread_mutex_lock(&report->lock);
+    mergeHistogram(&merged->turnaround, &result->latency.turnaround);
+    mergeHistogram(&merged->waiting, &result->latency.waiting);
+    mergeHistogram(&merged->response, &result->latency.response);
+    pthread_mutex_unlock(&report->lock);
+}
+
+// Free a latency report
+void freeLatencyReport(LatencyReport* report) {
+    pthread_mutex_destroy(&report->lock);
+    free(report->algorithms);
+    free(report);
+}
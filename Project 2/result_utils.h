@@ -0,0 +1,109 @@
+#ifndef RESULT_UTILS_H
+#define RESULT_UTILS_H
+
+#include <pthread.h>
+#include "process_utils.h"
+#include "histogram_utils.h"
+#include "predict_utils.h"
+
+#define NUM_PRIORITIES 4 // Priority levels 1 (highest) to 4
+
+// Metrics of one finished process
+typedef struct ProcessRecord {
+    int pid;            // Process ID
+    int arrivalTime;    // Arrival time
+    int runtime;        // Total runtime
+    int ioTime;         // Total time blocked on I/O
+    int priority;       // Priority level
+    int deadline;       // Deadline, or NO_DEADLINE
+    int startTime;      // Time at which the process first got the CPU
+    int completionTime; // Time at which the process finished
+} ProcessRecord;
+
+// Distributions of the turnaround, waiting and response times of finished processes
+typedef struct LatencyHistograms {
+    Histogram turnaround;
+    Histogram waiting;
+    Histogram response;
+} LatencyHistograms;
+
+// Metrics of one CPU of a multi-core run
+typedef struct CoreResult {
+    int completed;              // Processes that finished on this core
+    double totalTurnaroundTime; // Sums over the processes that finished on this core
+    double totalWaitingTime;
+    double totalResponseTime;
+    int busyTime;               // Quanta the core was not idle, switches and migrations included
+    int migrations;             // Processes dispatched here that last ran on another core
+    int migrationTime;          // Quanta spent moving processes to this core
+    int steals;                 // Processes this core took from another core's run queue
+    int contextSwitches;        // Times this core switched to a different process than the one that ran last
+    Timeline* timeline;         // Schedule of this core (detailed results only)
+} CoreResult;
+
+// Results of one algorithm run. Algorithms only record into it while they simulate;
+// it is printed (or just reduced into the final averages) once the run is over.
+typedef struct RunResult {
+    int completed;              // Number of finished processes
+    double totalTurnaroundTime; // Sums over the finished processes
+    double totalWaitingTime;
+    double totalResponseTime;
+    float avgTurnaroundTime;    // Averages, filled in by finishRunResult()
+    float avgWaitingTime;
+    float avgResponseTime;
+    float throughput;           // Finished processes per quantum of schedule
+    float utilization;          // Share of CPU time spent running processes: not idle or switching (migrations count as running)
+    int totalTime;              // Length of the schedule in quanta
+    int runTime;                // Quanta the CPUs spent running processes
+    int contextSwitches;        // Times the CPU switched to a different process than the one that ran last
+    int switchTime;             // Quanta spent on context switches, summed over the CPUs
+    int decisions;              // Times the algorithm picked a process to give a CPU (counted where it picks)
+    int predictedBursts;        // CPU bursts whose length was predicted (predicted algorithms only)
+    float predictionError;      // Mean absolute error of those predictions, in quanta
+    int stoppedAt;              // Horizon at which the run was cut off, or 0 if it was not
+    int deadlineProcesses;      // Finished processes that had a deadline
+    int deadlineMisses;         // Of those, the ones that finished after it
+    float missRate;             // deadlineMisses / deadlineProcesses, filled in by finishRunResult()
+    int* lateness;              // Completion time minus deadline of every finished process that had one
+    int latenessP50;            // Lateness percentiles, filled in by finishRunResult()
+    int latenessP90;
+    int latenessP99;
+    int latenessMax;
+    LatencyHistograms latency;  // Distributions of the finished processes' times
+    int reportByPriority;       // Break the results down by priority level when printing
+    int reportShares;           // Also compare each level's CPU share with its share of the tickets
+    double cpuTime[NUM_PRIORITIES];      // CPU time received by each priority level
+    double entitledTime[NUM_PRIORITIES]; // CPU time each level's tickets entitled it to
+    ProcessRecord* records;     // Finished processes in the order they were recorded (detailed results only)
+    Timeline* timeline;         // Schedule of the run (detailed single-CPU results only)
+    int numCores;               // Number of CPUs of a multi-core run, or 0 for a single-CPU run
+    CoreResult* cores;          // Per-core results of a multi-core run, or NULL
+    double loadImbalance;       // Time-averaged gap between the most and least loaded per-core run queues
+} RunResult;
+
+// Latency distributions of every algorithm merged over all of its runs. Safe to share between
+// threads; merging only adds counts, so the totals do not depend on the order runs finish in.
+typedef struct LatencyReport {
+    int numAlgorithms;
+    LatencyHistograms* algorithms; // algorithms[a] = merged distributions of algorithm a
+    pthread_mutex_t lock;          // Serializes merges from concurrent runs
+} LatencyReport;
+
+// Run result utilities
+void initRunResult(RunResult* result, int numProcesses, int detailed);
+void recordCompletion(RunResult* result, const Process* process);
+void finishRunResult(RunResult* result, Timeline* t);
+void recordShares(RunResult* result, const long long tickets[], double time);
+void recordPredictions(RunResult* result, const BurstPredictor* predictor);
+void initCoreResults(RunResult* result, int numCores);
+void recordCoreCompletion(RunResult* result, int core, const Process* process);
+void finishMulticoreResult(RunResult* result, Timeline* timelines[]);
+void printRunResult(const RunResult* result, const char* title);
+void freeRunResult(RunResult* result);
+
+// Latency report utilities
+LatencyReport* createLatencyReport(int numAlgorithms);
+void mergeLatencyReport(LatencyReport* report, int algorithm, const RunResult* result);
+void freeLatencyReport(LatencyReport* report);
+
+#endif
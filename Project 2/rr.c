@@ -2,85 +2,88 @@
 #include <stdlib.h>
 #include "process_utils.h"
 #include "queue_utils.h"
+#include "event_utils.h"
 #include "simulation.h"
 
-void roundRobin(Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput) {
+void roundRobin(Process processes[], int numProcesses, const SimConfig* config, RunResult* result) {
     int currTime = 0, completedProcesses = 0;
-    float totalTurnaroundTime = 0, totalWaitingTime = 0, totalResponseTime = 0;
     Timeline* t = createTimeline(100);
-    Queue* readyQueue = createQueue(numProcesses);
-
-    printf("\nRound Robin Scheduling (Quantum = 1):\n");
+    HandleQueue* readyQueue = createHandleQueue(numProcesses);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
 
     while (completedProcesses < numProcesses) {
-        // Check the current time to ensure processes don't start at or beyond the 100th quantum
-        if (currTime >= 100)
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currTime >= config->horizon)
         {
-            printf("Stopping simulation since a process cannot be executed at or beyond the 100th quantum.\n");
+            result->stoppedAt = config->horizon;
             break;
         }
-        // Add processes arriving at the current time to the ready queue
-        for (int i = 0; i < numProcesses; i++) {
-            if (processes[i].arrivalTime == currTime && processes[i].remainingTime > 0) {
-                enqueue(readyQueue, processes[i]);
-            }
+        // Add processes arriving (or finishing their I/O) at the current time to the ready queue
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currTime)) != -1) {
+            enqueueHandle(readyQueue, arrived);
         }
 
-        if (!isQueueEmpty(readyQueue)) {
+        if (!isHandleQueueEmpty(readyQueue)) {
             // Fetch the next process from the ready queue
-            Process currProcess = dequeue(readyQueue);
+            int handle = dequeueHandle(readyQueue);
+            Process* currProcess = &processes[handle];
+            result->decisions++;
 
-            if (currProcess.startTime == -1) {
-                currProcess.startTime = currTime; // Mark the process as started
+            // Execute the process for one quantum, or less if it finishes first. With nobody else waiting,
+            // every following quantum would pick it again, so it keeps the CPU until it finishes or the
+            // quantum in which the next process arrives is over. A context switch to it delays the slice.
+            int runUntil = currTime + currProcess->remainingTime;
+            if (runUntil > config->horizon) {
+                runUntil = config->horizon;
             }
+            int slice;
+            if (isHandleQueueEmpty(readyQueue)) {
+                slice = nextEventTime(&arrivals, currTime, runUntil) - currTime;
+                slice = (slice + config->quantum - 1) / config->quantum * config->quantum;
+            } else {
+                slice = config->quantum;
+            }
+            if (slice > runUntil - currTime) {
+                slice = runUntil - currTime;
+            }
+            currTime = switchContext(t, currTime, currProcess->pid, config->switchCost);
+            if (currProcess->startTime == -1) {
+                currProcess->startTime = currTime; // Mark the process as started
+            }
+            updateTimeline(t, currTime, slice, currProcess->pid);
 
-            // Execute the process for one quantum
-            updateTimeline(t, currTime, 1, currProcess.name);
-
-            currTime++;
-            currProcess.remainingTime--;
-
-            if (currProcess.remainingTime == 0) {
-                // Process has completed
-                completedProcesses += 1;
-                currProcess.completionTime = currTime;
+            currTime += slice;
+            currProcess->remainingTime -= slice;
 
-                int tat = currProcess.completionTime - currProcess.arrivalTime;
-                int rt = currProcess.startTime - currProcess.arrivalTime;
-                int wt = tat - currProcess.runtime;
+            // Processes that arrived during the slice queue up ahead of the preempted process
+            while ((arrived = nextArrival(&arrivals, currTime - 1)) != -1) {
+                enqueueHandle(readyQueue, arrived);
+            }
 
-                totalTurnaroundTime += tat;
-                totalResponseTime += rt;
-                totalWaitingTime += wt;
+            if (currProcess->remainingTime == 0) {
+                // The CPU burst is over: the process has completed, or blocks until its I/O is done
+                if (finishBurst(&arrivals, handle, currTime)) {
+                    completedProcesses += 1;
+                    currProcess->completionTime = currTime;
 
-                // printf("\nProcess %c: Arrival Time = %d, Runtime = %d, Turnaround Time = %d, Waiting Time = %d, Response Time = %d\n",
-                //        currProcess.name, currProcess.arrivalTime, currProcess.runtime, tat, wt, rt);
+                    recordCompletion(result, currProcess);
+                }
             } else {
                 // Process has not completed; re-add it to the ready queue
-                enqueue(readyQueue, currProcess);
+                enqueueHandle(readyQueue, handle);
             }
         } else {
-            // CPU is idle
-            updateTimeline(t, currTime, 1, '-');
-            currTime++;
+            // CPU is idle until the next arrival
+            currTime = skipIdleTime(&arrivals, t, currTime, config->horizon);
         }
     }
 
-    printTimeline(t);
-
-    // Calculate averages for this run
-    *avgTurnaroundTime = totalTurnaroundTime / completedProcesses;
-    *avgWaitingTime = totalWaitingTime / completedProcesses;
-    *avgResponseTime = totalResponseTime / completedProcesses;
-    *throughput = (float)completedProcesses / t->size;
-
-    // Display averages
-    printf("\nAverage Turnaround Time: %.2f\n", *avgTurnaroundTime);
-    printf("Average Waiting Time: %.2f\n", *avgWaitingTime);
-    printf("Average Response Time: %.2f\n", *avgResponseTime);
-    printf("Throughput: %.2f processes/unit time\n", *throughput);
+    // Calculate averages for this run; the result takes over the timeline
+    finishRunResult(result, t);
 
     // Free allocated resources
-    freeTimeline(t);
-    freeQueue(readyQueue);
+    freeHandleQueue(readyQueue);
+    freeArrivalCursor(&arrivals);
 }
\ No newline at end of file
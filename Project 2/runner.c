@@ -0,0 +1,312 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "runner.h"
+#include "arena_utils.h"
+
+// All algorithms, in the order they are run and reported. A %d in a title shows the run's Round Robin quantum.
+const Scheduler schedulers[] = {
+    { "FCFS", "First-Come First-Served (FCFS) Scheduling", fcfs, POLICY_FCFS, NULL },
+    { "SJF", "Shortest Job First (Non-Preemptive) Scheduling", sjf, POLICY_SJF, NULL },
+    { "SRTF", "Shortest Remaining Time First Scheduling", srtf, POLICY_SRTF, NULL },
+    { "SJF Predicted", "Shortest Job First (Non-Preemptive, Predicted Bursts) Scheduling", predictedSjf, POLICY_SJF_PREDICTED, "SJF" },
+    { "SRTF Predicted", "Shortest Remaining Time First (Predicted Bursts) Scheduling", predictedSrtf, POLICY_SRTF_PREDICTED, "SRTF" },
+    { "EDF", "Earliest Deadline First (Preemptive) Scheduling", edf, POLICY_EDF, NULL },
+    { "LLF", "Least Laxity First Scheduling", leastLaxityFirst, POLICY_LLF, NULL },
+    { "RR", "Round Robin Scheduling (Quantum = %d)", roundRobin, POLICY_RR, NULL },
+    { "WS", "Work-Stealing Round Robin Scheduling (Quantum = %d)", workStealing, POLICY_WORK_STEALING, NULL },
+    { "HPF Non-Preemptive", "Highest Priority First (Non-Preemptive) Scheduling", runNonPreemptive, POLICY_HPF_NP, NULL },
+    { "HPF Preemptive", "Highest Priority First (Preemptive) Scheduling", runPreemptive, POLICY_HPF_P, NULL },
+    { "MLFQ", "Multilevel Feedback Queue Scheduling", multilevelFeedbackQueue, POLICY_MLFQ, NULL },
+    { "CFS", "Completely Fair Scheduler (CFS) Scheduling", cfs, POLICY_CFS, NULL },
+    { "Lottery", "Lottery Scheduling (Quantum = %d)", lottery, POLICY_LOTTERY, NULL },
+    { "Stride", "Stride Scheduling (Quantum = %d)", stride, POLICY_STRIDE, NULL },
+};
+const int numSchedulers = sizeof(schedulers) / sizeof(schedulers[0]);
+
+// Default settings of a run. Fields are named, so adding one to SimConfig cannot shift the others.
+SimConfig defaultSimConfig(void)
+{
+    SimConfig config = {
+        .horizon = DEFAULT_HORIZON,
+        .verbosity = DEFAULT_VERBOSITY,
+        .runSink = NULL,
+        .processSink = NULL,
+        .quantum = DEFAULT_QUANTUM,
+        .cfsLatency = DEFAULT_CFS_LATENCY,
+        .mlfq = DEFAULT_MLFQ_CONFIG,
+        .cpus = DEFAULT_CPUS,
+        .queueLayout = QUEUES_GLOBAL,
+        .migrationCost = 0,
+        .seed = 0,
+        .trial = 0,
+        .deadlineFactor = DEFAULT_DEADLINE_FACTOR,
+        .switchCost = 0,
+        .ioPercent = 0,
+        .predictionAlpha = DEFAULT_PREDICTION_ALPHA,
+        .selection = SELECT_AUTO,
+        .latency = NULL,
+        .tracePath = NULL,
+        .trace = NULL,
+    };
+    return config;
+}
+
+// Run one algorithm on a private copy of a workload, leaving the workload untouched. Without a workload
+// the run replays the binary trace config->tracePath through its own reader instead, reading each process
+// into its slot when it arrives. The slots are never reused, since the algorithms keep state per handle,
+// so a run still holds every process it has read: O(N) memory per run, and per thread. With more than one CPU the
+// algorithm's policy runs on the multi-core simulator instead. Everything the run allocates comes from
+// the thread's run arena, which is reset in one step when the run is over.
+// The run is reported once it is over, at the configured verbosity, exported to any sinks and its
+// latency distributions are merged into the latency report.
+void runScheduler(const Scheduler* scheduler, Process* workload, int numProcesses, const SimConfig* trialConfig, int trial, TrialResult* result)
+{
+    SimConfig runConfig = *trialConfig;
+    runConfig.trial = trial;
+    const SimConfig* config = &runConfig;
+    openRunArena();
+    Process* processes = (Process*)runAlloc(numProcesses * sizeof(Process));
+    if (processes == NULL)
+    {
+        fprintf(stderr, "Error allocating processes for %s!\n", scheduler->name);
+        exit(EXIT_FAILURE);
+    }
+    if (workload != NULL)
+    {
+        copyProcesses(processes, workload, numProcesses);
+    }
+    else
+    {
+        runConfig.trace = openWorkload(config->tracePath);
+    }
+    RunResult run;
+    initRunResult(&run, numProcesses, config->verbosity >= VERBOSITY_FULL || config->processSink != NULL);
+    if (config->cpus > 1)
+    {
+        runMulticore(scheduler->policy, processes, numProcesses, config, &run);
+    }
+    else
+    {
+        scheduler->run(processes, numProcesses, config, &run);
+    }
+    if (config->verbosity >= VERBOSITY_SUMMARY)
+    {
+        char title[128];
+        int length = snprintf(title, sizeof(title), scheduler->title, config->quantum);
+        if (config->cpus > 1 && length < (int)sizeof(title))
+        {
+            const char* layout = (config->queueLayout == QUEUES_PER_CORE) ? "per-core run queues" : "global run queue";
+            if (scheduler->policy == POLICY_WORK_STEALING)
+            {
+                layout = "per-core deques";
+            }
+            snprintf(title + length, sizeof(title) - length, " on %d CPUs (%s)", config->cpus, layout);
+        }
+        printRunResult(&run, title);
+    }
+    if (config->runSink != NULL)
+    {
+        exportRunResult(config->runSink, trial, scheduler->name, &run);
+    }
+    if (config->processSink != NULL)
+    {
+        exportRunResult(config->processSink, trial, scheduler->name, &run);
+    }
+    if (config->latency != NULL)
+    {
+        mergeLatencyReport(config->latency, (int)(scheduler - schedulers), &run);
+    }
+    result->avgTurnaroundTime = run.avgTurnaroundTime;
+    result->avgWaitingTime = run.avgWaitingTime;
+    result->avgResponseTime = run.avgResponseTime;
+    result->throughput = run.throughput;
+    result->utilization = run.utilization;
+    result->missRate = (run.deadlineProcesses > 0) ? run.missRate : -1;
+    result->predictionError = (run.predictedBursts > 0) ? run.predictionError : -1;
+    result->contextSwitches = run.contextSwitches;
+    freeRunResult(&run);
+    if (runConfig.trace != NULL)
+    {
+        closeWorkload(runConfig.trace);
+    }
+    runFree(processes);
+    closeRunArena();
+}
+
+// Shared state of a task pool: workers claim task indices from a counter until none are left
+typedef struct TaskPool {
+    pthread_mutex_t lock;
+    int nextTask;
+    int numTasks;
+    TaskFn fn;
+    void* context;
+} TaskPool;
+
+static void* taskWorker(void* arg)
+{
+    TaskPool* pool = (TaskPool*)arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        int task = pool->nextTask++;
+        pthread_mutex_unlock(&pool->lock);
+        if (task >= pool->numTasks)
+        {
+            freeRunArena();
+            return NULL;
+        }
+        pool->fn(task, pool->context);
+    }
+}
+
+// Run tasks 0..numTasks-1 on up to numThreads threads and wait for all of them.
+// Tasks are claimed one at a time, so a slow trial does not hold up an idle thread.
+void runTasks(int numTasks, int numThreads, TaskFn fn, void* context)
+{
+    if (numThreads > numTasks)
+    {
+        numThreads = numTasks;
+    }
+    if (numThreads <= 1)
+    {
+        for (int task = 0; task < numTasks; task++)
+        {
+            fn(task, context);
+        }
+        return;
+    }
+
+    TaskPool pool;
+    pthread_mutex_init(&pool.lock, NULL);
+    pool.nextTask = 0;
+    pool.numTasks = numTasks;
+    pool.fn = fn;
+    pool.context = context;
+
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    if (threads == NULL)
+    {
+        fprintf(stderr, "Error allocating worker threads!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < numThreads; i++)
+    {
+        if (pthread_create(&threads[i], NULL, taskWorker, &pool) != 0)
+        {
+            fprintf(stderr, "Error creating worker thread %d!\n", i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int i = 0; i < numThreads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&pool.lock);
+}
+
+// Everything the batch tasks need; each task only writes its own workload or result slot
+typedef struct TrialBatch {
+    int firstTrial;
+    int numProcesses;
+    const SimConfig* config;
+    uint64_t seed;
+    Process** workloads; // NULL when replaying a trace
+    TrialResult* results;
+} TrialBatch;
+
+// Generate the workload of one trial from its own random stream
+static void generateTrial(int trial, void* context)
+{
+    TrialBatch* batch = (TrialBatch*)context;
+    Rng rng;
+    rngStream(&rng, batch->seed, batch->firstTrial + trial);
+    batch->workloads[trial] = (Process*)malloc(batch->numProcesses * sizeof(Process));
+    if (batch->workloads[trial] == NULL)
+    {
+        fprintf(stderr, "Error allocating processes for trial %d!\n", batch->firstTrial + trial + 1);
+        exit(EXIT_FAILURE);
+    }
+    generateProcesses(batch->workloads[trial], batch->numProcesses, batch->config->horizon, batch->config->deadlineFactor, batch->config->ioPercent, &rng);
+}
+
+// Run one (trial, algorithm) pair quietly
+static void runTrialTask(int task, void* context)
+{
+    TrialBatch* batch = (TrialBatch*)context;
+    int trial = task / numSchedulers;
+    SimConfig config = *batch->config;
+    config.verbosity = VERBOSITY_QUIET;
+    Process* workload = (batch->workloads != NULL) ? batch->workloads[trial] : NULL;
+    runScheduler(&schedulers[task % numSchedulers], workload, batch->numProcesses, &config, batch->firstTrial + trial + 1, &batch->results[task]);
+}
+
+// Run every algorithm on trials firstTrial to firstTrial + numTrials - 1 concurrently. Trial t draws
+// from stream t of the seed, so the results match a sequential run with the same seed. If the config
+// has a trace, every trial replays it instead, each run reading it through a reader of its own.
+// results[t * numSchedulers + s] receives the metrics of scheduler s on trial firstTrial + t.
+void runTrialsParallel(int firstTrial, int numTrials, int numProcesses, const SimConfig* config, uint64_t seed, int numThreads, TrialResult* results)
+{
+    TrialBatch batch;
+    batch.firstTrial = firstTrial;
+    batch.numProcesses = numProcesses;
+    batch.config = config;
+    batch.seed = seed;
+    batch.results = results;
+    batch.workloads = NULL;
+
+    if (config->tracePath == NULL)
+    {
+        batch.workloads = (Process**)malloc(numTrials * sizeof(Process*));
+        if (batch.workloads == NULL)
+        {
+            fprintf(stderr, "Error allocating trial workloads!\n");
+            exit(EXIT_FAILURE);
+        }
+        runTasks(numTrials, numThreads, generateTrial, &batch);
+    }
+    runTasks(numTrials * numSchedulers, numThreads, runTrialTask, &batch);
+
+    if (batch.workloads != NULL)
+    {
+        for (int trial = 0; trial < numTrials; trial++)
+        {
+            free(batch.workloads[trial]);
+        }
+        free(batch.workloads);
+    }
+}
+
+// Add an algorithm's result on one trial to its statistics
+void addTrialResult(AlgorithmStats* stats, const TrialResult* result)
+{
+    addSample(&stats->turnaround, result->avgTurnaroundTime);
+    addSample(&stats->waiting, result->avgWaitingTime);
+    addSample(&stats->response, result->avgResponseTime);
+    addSample(&stats->throughput, result->throughput);
+    addSample(&stats->utilization, 100.0 * result->utilization);
+    addSample(&stats->contextSwitches, result->contextSwitches);
+    if (result->missRate >= 0)
+    {
+        addSample(&stats->missRate, 100.0 * result->missRate);
+    }
+    if (result->predictionError >= 0)
+    {
+        addSample(&stats->predictionError, result->predictionError);
+    }
+}
+
+// Whether the 95% confidence interval of every algorithm's mean turnaround time is within target
+// percent of the mean
+int ciTargetReached(const AlgorithmStats stats[], int numAlgorithms, double target)
+{
+    for (int s = 0; s < numAlgorithms; s++)
+    {
+        if (stats[s].turnaround.count < 2 || confidenceHalfWidth(&stats[s].turnaround) > stats[s].turnaround.mean * target / 100)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
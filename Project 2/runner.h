@@ -0,0 +1,60 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include "process_utils.h"
+#include "simulation.h"
+#include "stats_utils.h"
+
+// Common signature of every scheduling algorithm
+typedef void (*SchedulerFn)(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+
+// A scheduling algorithm and the label it is reported under
+typedef struct Scheduler {
+    const char* name;  // Label used in the FINAL AVERAGES table
+    const char* title; // Heading printed above each run's results (may contain one %d for the quantum)
+    SchedulerFn run;   // Algorithm entry point
+    int policy;        // POLICY_* value the multi-core simulator runs it as
+    const char* oracle; // Name of the algorithm that knows the burst lengths this one predicts, or NULL
+} Scheduler;
+
+// Averages produced by one algorithm on one trial, kept for the final reduction
+typedef struct TrialResult {
+    float avgTurnaroundTime;
+    float avgWaitingTime;
+    float avgResponseTime;
+    float throughput;
+    float utilization;  // Share of CPU time spent running processes
+    float missRate;     // Deadline miss rate, or -1 if no finished process had a deadline
+    float predictionError; // Mean absolute burst prediction error, or -1 if the algorithm predicts none
+    int contextSwitches; // Context switches of the run
+} TrialResult;
+
+#define DEFAULT_MAX_TRIALS 1000 // Trials after which --ci-target gives up
+
+// Statistics of one algorithm's trial results over all trials so far
+typedef struct AlgorithmStats {
+    OnlineStats turnaround;
+    OnlineStats waiting;
+    OnlineStats response;
+    OnlineStats throughput;
+    OnlineStats utilization; // In percent
+    OnlineStats contextSwitches;
+    OnlineStats missRate;  // In percent, over the trials in which a process with a deadline finished
+    OnlineStats predictionError; // In quanta per burst, over the trials in which a burst was predicted
+} AlgorithmStats;
+
+// Batch of independent tasks; task i is run as fn(i, context) on some worker thread
+typedef void (*TaskFn)(int task, void* context);
+
+extern const Scheduler schedulers[];
+extern const int numSchedulers;
+
+// Runner utilities
+SimConfig defaultSimConfig(void);
+void runScheduler(const Scheduler* scheduler, Process* workload, int numProcesses, const SimConfig* config, int trial, TrialResult* result);
+void runTasks(int numTasks, int numThreads, TaskFn fn, void* context);
+void runTrialsParallel(int firstTrial, int numTrials, int numProcesses, const SimConfig* config, uint64_t seed, int numThreads, TrialResult* results);
+void addTrialResult(AlgorithmStats* stats, const TrialResult* result);
+int ciTargetReached(const AlgorithmStats stats[], int numAlgorithms, double target);
+
+#endif
@@ -0,0 +1,96 @@
+#include <limits.h>
+#include "select_utils.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SELECT_X86 1
+#endif
+
+// Smallest of n keys, or INT_MAX if there are none
+int minKey(const int* keys, int n) {
+    int smallest = INT_MAX;
+    for (int i = 0; i < n; i++) {
+        smallest = (keys[i] < smallest) ? keys[i] : smallest;
+    }
+    return smallest;
+}
+
+// Handle with the smallest key, ties going to the smallest handle (the order of a ReadyHeap), or -1
+// if n is 0. handles[i] is the handle whose key is keys[i]; both arrays are scanned front to back.
+int argminHandleScalar(const int* keys, const int* handles, int n) {
+    if (n == 0) {
+        return -1;
+    }
+    int smallest = minKey(keys, n);
+    int handle = INT_MAX;
+    for (int i = 0; i < n; i++) {
+        int candidate = (keys[i] == smallest) ? handles[i] : INT_MAX;
+        handle = (candidate < handle) ? candidate : handle;
+    }
+    return handle;
+}
+
+#ifdef SELECT_X86
+// Smallest of the eight lanes of a vector
+__attribute__((target("avx2")))
+static int horizontalMin(__m256i v) {
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(m);
+}
+
+// argminHandleScalar() eight keys at a time: one pass for the smallest key, and one for the smallest
+// handle among the slots holding it. The last n % 8 slots are done one by one.
+__attribute__((target("avx2")))
+int argminHandleAvx2(const int* keys, const int* handles, int n) {
+    if (n == 0) {
+        return -1;
+    }
+    const __m256i none = _mm256_set1_epi32(INT_MAX);
+    int tail = n - n % 8;
+
+    __m256i smallestLanes = none;
+    for (int i = 0; i < tail; i += 8) {
+        smallestLanes = _mm256_min_epi32(smallestLanes, _mm256_loadu_si256((const __m256i*)(keys + i)));
+    }
+    int smallest = horizontalMin(smallestLanes);
+    for (int i = tail; i < n; i++) {
+        smallest = (keys[i] < smallest) ? keys[i] : smallest;
+    }
+
+    const __m256i target = _mm256_set1_epi32(smallest);
+    __m256i handleLanes = none;
+    for (int i = 0; i < tail; i += 8) {
+        __m256i match = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(keys + i)), target);
+        __m256i candidates = _mm256_blendv_epi8(none, _mm256_loadu_si256((const __m256i*)(handles + i)), match);
+        handleLanes = _mm256_min_epi32(handleLanes, candidates);
+    }
+    int handle = horizontalMin(handleLanes);
+    for (int i = tail; i < n; i++) {
+        int candidate = (keys[i] == smallest) ? handles[i] : INT_MAX;
+        handle = (candidate < handle) ? candidate : handle;
+    }
+    return handle;
+}
+
+// Check if the CPU running the program supports AVX2
+int hasAvx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+#else
+// Without x86 there is no AVX2 kernel; the scalar one stands in so the name always links
+int argminHandleAvx2(const int* keys, const int* handles, int n) {
+    return argminHandleScalar(keys, handles, n);
+}
+
+// Check if the CPU running the program supports AVX2
+int hasAvx2(void) {
+    return 0;
+}
+#endif
+
+// Fastest argmin kernel the CPU running the program supports
+ArgminKernel bestArgminKernel(void) {
+    return hasAvx2() ? argminHandleAvx2 : argminHandleScalar;
+}
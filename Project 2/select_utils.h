@@ -0,0 +1,17 @@
+#ifndef SELECT_UTILS_H
+#define SELECT_UTILS_H
+
+// Minimum searches over contiguous arrays of keys. The scalar loops are branch-free, so the compiler
+// can vectorize them for the baseline instruction set; the AVX2 kernel compares eight keys at a time
+// and is only called on CPUs that support it.
+
+// Kernel returning the handle with the smallest key, ties going to the smallest handle, or -1 if n is 0
+typedef int (*ArgminKernel)(const int* keys, const int* handles, int n);
+
+int minKey(const int* keys, int n);
+int argminHandleScalar(const int* keys, const int* handles, int n);
+int argminHandleAvx2(const int* keys, const int* handles, int n);
+int hasAvx2(void);
+ArgminKernel bestArgminKernel(void);
+
+#endif
@@ -5,16 +5,139 @@
 #include <string.h>
 #include "process_utils.h"
 #include "queue_utils.h"
+#include "result_utils.h"
+#include "export_utils.h"
+#include "workload_utils.h"
 
-void fcfs(Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void sjf(Process* processes, int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-Process* getSRTFProcess(Queue* q);
-void removeFromQueue(Queue* q, Process* p);
-void srtf(Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void roundRobin(Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void simulateHPFNonPreemptive(int runIndex, Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void runNonPreemptive(Process *processes, int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void simulateHPFPreemptive(int runIndex, Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void runPreemptive(Process *processes, int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void printRunStatisticsNonPreemptive(Process *processes, int numProcesses, int totalRunTime, Timeline *timeline, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
-void printRunStatisticsPreemptive(Process *processes, int numProcesses, int totalRunTime, Timeline *timeline, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput);
\ No newline at end of file
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#define DEFAULT_HORIZON 100 // Default quantum at or beyond which no process may start
+#define NO_HORIZON INT_MAX  // Horizon used when replaying a trace: every process may start
+#define DEFAULT_QUANTUM 1   // Default Round Robin time slice
+
+#define DEFAULT_CFS_LATENCY 6 // CFS target latency: quanta in which every runnable process should run once
+#define CFS_VRUNTIME_SHIFT 20  // CFS virtual runtime is kept in 1/2^20 quanta of nice-0 CPU time
+#define CFS_WAKEUP_GRANULARITY (1LL << CFS_VRUNTIME_SHIFT) // Virtual runtime lead at which a waiting process preempts
+
+#define STRIDE1 (1LL << 20) // Stride of a process holding one ticket; a process's stride is STRIDE1 / tickets
+#define LOTTERY_STREAM_BASE (1ULL << 32) // Lottery draws of trial t come from stream LOTTERY_STREAM_BASE + t of the seed
+
+#define DEFAULT_DEADLINE_FACTOR 4 // Generated deadlines fall 1 to 4 runtimes after arrival
+#define MAX_DEADLINE_FACTOR 1000  // Largest deadline factor, so deadlines cannot overflow
+
+#define DEFAULT_CPUS 1      // Number of CPUs; more than one runs every policy on the multi-core simulator
+
+// Run queue layouts of a multi-core run
+#define QUEUES_GLOBAL 0     // One run queue shared by all CPUs
+#define QUEUES_PER_CORE 1   // One run queue per CPU; arrivals join the least loaded one
+
+// Policies of the multi-core simulator, one per single-CPU algorithm
+#define POLICY_FCFS 0
+#define POLICY_SJF 1
+#define POLICY_SRTF 2
+#define POLICY_RR 3
+#define POLICY_HPF_NP 4
+#define POLICY_HPF_P 5
+#define POLICY_MLFQ 6
+#define POLICY_WORK_STEALING 7 // Round Robin on per-CPU deques; idle CPUs steal from the busiest peer
+#define POLICY_CFS 8
+#define POLICY_LOTTERY 9
+#define POLICY_STRIDE 10
+#define POLICY_EDF 11
+#define POLICY_LLF 12
+#define POLICY_SJF_PREDICTED 13  // SJF on burst lengths predicted from past bursts
+#define POLICY_SRTF_PREDICTED 14 // SRTF on remaining times predicted from past bursts
+
+// How SJF and SRTF find the shortest ready process
+#define SELECT_HEAP 0       // Binary heap: O(log n) per decision
+#define SELECT_SCAN 1       // Scan of the ready processes' keys, kept in a dense array: O(n), but sequential
+#define SELECT_AUTO 2       // Scan in runs too small for the ready set to outgrow the scan, heap otherwise
+
+// Where a scan stops beating the heap depends on the CPU, so --select auto measures it once per program:
+// it times both on ready sets of doubling size until the heap wins twice in a row
+#define SCAN_CALIBRATION_MIN_READY 4      // Smallest ready set timed
+#define SCAN_CALIBRATION_MAX_READY 1024   // Largest ready set timed; the heap wins well before this
+#define SCAN_CALIBRATION_SELECTIONS 20000 // Selections timed per try
+#define SCAN_CALIBRATION_TRIES 3          // Tries per structure and size; the fastest one counts
+#define SCAN_CALIBRATION_MAX_KEY 1000     // Keys are drawn from 1 to this, so ties occur
+#define SCAN_CALIBRATION_MARGIN 1.05      // The scan must be this much faster, so near-ties go to the heap
+
+#define MLFQ_MAX_LEVELS 8   // Most levels a multilevel feedback queue may have
+#define DEFAULT_MLFQ_CONFIG { 3, { 1, 2, 4 }, 20 } // Three levels with quanta 1, 2 and 4, boosted every 20 quanta
+
+// Output levels. Algorithms never print; results are reported after each run at these levels.
+#define VERBOSITY_QUIET 0   // Only the final averages
+#define VERBOSITY_SUMMARY 1 // Plus the averages of every run
+#define VERBOSITY_FULL 2    // Plus generated processes, per-process results and time charts
+
+// Compile with -DDEFAULT_VERBOSITY=0 for benchmark builds
+#ifndef DEFAULT_VERBOSITY
+#define DEFAULT_VERBOSITY VERBOSITY_FULL
+#endif
+
+// Multilevel feedback queue settings. Level 0 is the highest priority.
+typedef struct MlfqConfig {
+    int levels;                   // Number of levels (1 to MLFQ_MAX_LEVELS)
+    int quanta[MLFQ_MAX_LEVELS];  // Time slice of each level
+    int boostInterval;            // Every process is moved back to level 0 this often (0 = never)
+} MlfqConfig;
+
+// Settings shared by all scheduling algorithms for one run
+typedef struct SimConfig {
+    int horizon;       // No process may be started at or beyond this quantum
+    int verbosity;     // One of the VERBOSITY_* levels
+    ResultSink* runSink;     // Receives one record per run, or NULL
+    ResultSink* processSink; // Receives one record per finished process, or NULL
+    int quantum;       // Round Robin time slice
+    int cfsLatency;    // CFS target latency in quanta
+    MlfqConfig mlfq;   // Multilevel feedback queue levels, quanta and boost interval
+    int cpus;          // Number of CPUs
+    int queueLayout;   // QUEUES_GLOBAL or QUEUES_PER_CORE (multi-core runs only)
+    int migrationCost; // Quanta a CPU loses when it runs a process that last ran on another CPU
+    uint64_t seed;     // Seed of the experiment; randomized policies draw from their own streams of it
+    int trial;         // Trial being simulated (1-based), set by runScheduler()
+    int deadlineFactor; // Generated processes must finish within 1 to deadlineFactor runtimes of arriving (0 = no deadlines)
+    int switchCost;    // Quanta a CPU spends switching to a different process than the one it last ran
+    int ioPercent;     // Percentage of generated processes that alternate CPU bursts with I/O bursts
+    double predictionAlpha; // Weight of the latest burst in the predicted algorithms' exponential average
+    int selection;     // SELECT_HEAP, SELECT_SCAN or SELECT_AUTO (SJF and SRTF on true burst lengths)
+    LatencyReport* latency; // Receives every run's latency distributions, or NULL
+    const char* tracePath;  // Trace every run replays instead of a generated workload, or NULL
+    WorkloadReader* trace;  // Reader the run streams the trace's processes from, set by runScheduler() (NULL without a trace)
+} SimConfig;
+
+
+void fcfs(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void sjf(Process* processes, int numProcesses, const SimConfig* config, RunResult* result);
+void srtf(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void predictedSjf(Process* processes, int numProcesses, const SimConfig* config, RunResult* result);
+void predictedSrtf(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void edf(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void leastLaxityFirst(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void roundRobin(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void runNonPreemptive(Process *processes, int numProcesses, const SimConfig* config, RunResult* result);
+void runPreemptive(Process *processes, int numProcesses, const SimConfig* config, RunResult* result);
+void multilevelFeedbackQueue(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void cfs(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void lottery(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void stride(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void workStealing(Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+void runMulticore(int policy, Process processes[], int numProcesses, const SimConfig* config, RunResult* result);
+
+// Ready queue of SJF and SRTF in the configured selection layout, shared with the multi-core simulator
+ReadyHeap* createShortestFirstHeap(const SimConfig* config, int capacity);
+int scanSelectMaxProcesses(void);
+double timeSelections(ReadyHeap* heap, const int* keys, int n, int selections);
+
+// CFS helpers, shared with the multi-core simulator
+int cfsWeight(int priority);
+long long cfsVruntime(int quanta, int priority);
+int cfsTimeSlice(const SimConfig* config, int priority, long long runnableWeight);
+
+// Proportional-share helpers, shared with the multi-core simulator
+int lotteryTickets(int priority);
+long long strideLength(int priority);
+int drawLottery(TicketTree* tickets, Rng* rng);
+
+#endif
@@ -2,110 +2,185 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <time.h>
+#include <pthread.h>
 #include "process_utils.h"
 #include "queue_utils.h"
+#include "event_utils.h"
+#include "predict_utils.h"
+#include "select_utils.h"
+#include "simulation.h"
+#include "rng_utils.h"
+
+static pthread_once_t scanCalibration = PTHREAD_ONCE_INIT;
+static int scanSelectMax = 0; // Largest ready set at which the scan beat the heap on this CPU
+
+// Time selections from a ready set of n processes as SJF makes them: each pops the process with the
+// smallest key and queues it again with a new key, as if the next process had arrived. Filling and
+// emptying the heap are not timed. Returns the nanoseconds per selection.
+double timeSelections(ReadyHeap* heap, const int* keys, int n, int selections) {
+    for (int h = 0; h < n; h++) {
+        heapInsert(heap, h, keys[h]);
+    }
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int s = 0; s < selections; s++) {
+        int handle = heapPop(heap);
+        heapInsert(heap, handle, keys[s % n]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    while (heapPop(heap) != -1) {
+    }
+    return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / selections;
+}
+
+// Fastest of SCAN_CALIBRATION_TRIES timings of a ready set of n processes
+static double fastestSelectionTime(ReadyHeap* heap, const int* keys, int n) {
+    double fastest = timeSelections(heap, keys, n, SCAN_CALIBRATION_SELECTIONS);
+    for (int t = 1; t < SCAN_CALIBRATION_TRIES; t++) {
+        double time = timeSelections(heap, keys, n, SCAN_CALIBRATION_SELECTIONS);
+        fastest = (time < fastest) ? time : fastest;
+    }
+    return fastest;
+}
+
+// Find the largest ready set at which a scan with the CPU's best argmin kernel still clearly beats the
+// heap, doubling the size from SCAN_CALIBRATION_MIN_READY until the heap wins twice in a row (a small heap
+// is shallow, so the two can tie at one size and the scan still win at the next)
+static void calibrateScanSelect(void) {
+    int* keys = (int*)malloc(SCAN_CALIBRATION_MAX_READY * sizeof(int));
+    if (keys == NULL) {
+        fprintf(stderr, "Error allocating calibration keys!\n");
+        exit(EXIT_FAILURE);
+    }
+    Rng rng;
+    rngStream(&rng, 0, 0);
+    for (int i = 0; i < SCAN_CALIBRATION_MAX_READY; i++) {
+        keys[i] = 1 + rngRange(&rng, SCAN_CALIBRATION_MAX_KEY);
+    }
+    ReadyHeap* heap = createReadyHeap(SCAN_CALIBRATION_MAX_READY);
+    ReadyHeap* scan = createScanHeap(SCAN_CALIBRATION_MAX_READY);
+    // Untimed pass first, so the smallest sets are not timed on a cold cache and an idle clock
+    timeSelections(scan, keys, SCAN_CALIBRATION_MAX_READY, SCAN_CALIBRATION_SELECTIONS);
+    timeSelections(heap, keys, SCAN_CALIBRATION_MAX_READY, SCAN_CALIBRATION_SELECTIONS);
+    int heapWins = 0;
+    for (int n = SCAN_CALIBRATION_MIN_READY; n <= SCAN_CALIBRATION_MAX_READY && heapWins < 2; n *= 2) {
+        if (fastestSelectionTime(scan, keys, n) * SCAN_CALIBRATION_MARGIN < fastestSelectionTime(heap, keys, n)) {
+            scanSelectMax = n;
+            heapWins = 0;
+        } else {
+            heapWins++;
+        }
+    }
+    freeReadyHeap(heap);
+    freeReadyHeap(scan);
+    free(keys);
+}
 
+// Largest run in which --select auto scans: the ready set up to which the CPU's best argmin kernel beats
+// the heap. It is measured the first time it is asked for; main asks before any worker thread starts, so
+// the timings are not disturbed by other runs.
+int scanSelectMaxProcesses(void) {
+    pthread_once(&scanCalibration, calibrateScanSelect);
+    return scanSelectMax;
+}
 
-void sjf(Process* processes, int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput) {
+// Ready queue of SJF and SRTF: a binary heap, or a dense array searched by scanning. By default the
+// scan is used when the ready set can never outgrow the size up to which it is faster.
+ReadyHeap* createShortestFirstHeap(const SimConfig* config, int capacity) {
+    int scan = (config->selection == SELECT_SCAN) ||
+               (config->selection == SELECT_AUTO && capacity <= scanSelectMaxProcesses());
+    return scan ? createScanHeap(capacity) : createReadyHeap(capacity);
+}
+
+// Shortest Job First on the true length of each CPU burst, or with a predictor on its estimate
+static void runSjf(Process* processes, int numProcesses, const SimConfig* config, RunResult* result, BurstPredictor* predictor) {
     int currentTime = 0;
     int completedProcesses = 0;
-    float totalTurnaroundTime = 0, totalWaitingTime = 0, totalResponseTime = 0;
 
-    // Initialize timeline with sufficient space for all quanta
-    Timeline* t = createTimeline(200); // Arbitrarily large size for dynamic tracking
-    
-    printf("\nShortest Job First (Non-Preemptive) Scheduling:\n");
+    // Initialize timeline; it grows by segments as jobs are scheduled
+    Timeline* t = createTimeline(200);
 
-    // Create a flag to track completed processes
-    int* isCompleted = (int*)calloc(numProcesses, sizeof(int));
+    // Arrived jobs keyed on the (predicted) length of their next CPU burst; ties fall back to arrival order
+    ReadyHeap* readyHeap = (predictor != NULL) ? createReadyHeap(numProcesses) : createShortestFirstHeap(config, numProcesses);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
 
     while (completedProcesses < numProcesses) {
-        // Check the current time to ensure processes don't start at or beyond the 100th quantum
-        if (currentTime >= 100)
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
         {
-            printf("Stopping simulation since a process cannot be executed at or beyond the 100th quantum.\n");
+            result->stoppedAt = config->horizon;
             break;
         }
-        // Find the shortest job that has arrived and is not yet completed
-        int shortestJobIndex = -1;
-        int shortestRuntime = INT_MAX;
-
-        for (int i = 0; i < numProcesses; i++) {
-            if (!isCompleted[i] && processes[i].arrivalTime <= currentTime) 
-            {
-                if (processes[i].runtime < shortestRuntime || (processes[i].runtime == shortestRuntime && processes[i].arrivalTime < processes[shortestJobIndex].arrivalTime))
-                {
-                    // This is to ensure that the shortest runtime is prioritized, and also to break ties by arrival time
-                    shortestRuntime = processes[i].runtime;
-                    shortestJobIndex = i;
-                }
-            }
+        // Add the jobs that arrived (or finished their I/O) while the previous one was running
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1) {
+            heapInsert(readyHeap, arrived, (predictor != NULL) ? predictedBurst(predictor, arrived) : processes[arrived].remainingTime);
         }
 
+        // Find the shortest job that has arrived and is not yet completed
+        int shortestJobIndex = heapPop(readyHeap);
+
         if (shortestJobIndex != -1) 
         {
-            // Process the selected job
+            // Process the selected job's CPU burst
             Process* shortestJob = &processes[shortestJobIndex];
-            shortestJob->startTime = currentTime;
-            shortestJob->completionTime = currentTime + shortestJob->runtime;
+            result->decisions++;
+            currentTime = switchContext(t, currentTime, shortestJob->pid, config->switchCost);
+            if (shortestJob->startTime == -1) {
+                shortestJob->startTime = currentTime;
+            }
 
             // Update the timeline with the process execution
-            updateTimeline(t, currentTime, shortestJob->runtime, shortestJob->name);
-
-            // Calculate metrics for the process
-            int turnaroundTime = shortestJob->completionTime - shortestJob->arrivalTime;
-            int waitingTime = turnaroundTime - shortestJob->runtime;
-            int responseTime = shortestJob->startTime - shortestJob->arrivalTime;
-
-            totalTurnaroundTime += turnaroundTime;
-            totalWaitingTime += waitingTime;
-            totalResponseTime += responseTime;
+            updateTimeline(t, currentTime, shortestJob->remainingTime, shortestJob->pid);
 
-            // Mark the process as completed
-            isCompleted[shortestJobIndex] = 1;
-            completedProcesses += 1;
+            // Move time forward
+            currentTime += shortestJob->remainingTime;
 
-            // Print process details
-            printf("Process %c: Arrival Time = %d, Runtime = %d, Turnaround Time = %d, Waiting Time = %d, Response Time = %d\n",
-                   shortestJob->name, shortestJob->arrivalTime, shortestJob->runtime,
-                   turnaroundTime, waitingTime, responseTime);
+            // Jobs that arrived while it ran are estimated before its burst is known, as a real scheduler would
+            while ((arrived = nextArrival(&arrivals, currentTime - 1)) != -1) {
+                heapInsert(readyHeap, arrived, (predictor != NULL) ? predictedBurst(predictor, arrived) : processes[arrived].remainingTime);
+            }
+            if (predictor != NULL) {
+                chargeBurst(predictor, shortestJobIndex, shortestJob->remainingTime);
+                endBurst(predictor, shortestJobIndex);
+            }
+            shortestJob->remainingTime = 0;
 
-            // Move time forward
-            currentTime = shortestJob->completionTime;
+            // Unless it blocks for I/O, mark the process as completed and record its metrics
+            if (finishBurst(&arrivals, shortestJobIndex, currentTime)) {
+                shortestJob->completionTime = currentTime;
+                completedProcesses += 1;
+                recordCompletion(result, shortestJob);
+            }
         } 
         else 
         {
-            // If no process is ready, mark CPU as idle, look ahead for the next arrival time
-            int arrivesNext = INT_MAX;
-            for (int i = 0; i < numProcesses; i++)
-            {
-                if (!isCompleted[i] && processes[i].arrivalTime > currentTime) 
-                {
-                    arrivesNext = (processes[i].arrivalTime < arrivesNext) ? processes[i].arrivalTime : arrivesNext;
-                }
-            }
-
-            // Update timeline to account for idle time
-            updateTimeline(t, currentTime, arrivesNext - currentTime, '-');
-            currentTime = arrivesNext;
+            // If no process is ready, mark CPU as idle and jump ahead to the next arrival time
+            currentTime = skipIdleTime(&arrivals, t, currentTime, config->horizon);
         }
     }
 
-    // Print the timeline
-    printTimeline(t);
+    // Calculate averages; the result takes over the timeline
+    if (predictor != NULL) {
+        recordPredictions(result, predictor);
+    }
+    finishRunResult(result, t);
 
-    // Calculate and print averages
-    *avgTurnaroundTime = totalTurnaroundTime / completedProcesses;
-    *avgWaitingTime = totalWaitingTime / completedProcesses;
-    *avgResponseTime = totalResponseTime / completedProcesses;
-    *throughput = (float)completedProcesses / t->size;
+    // Free allocated memory
+    freeReadyHeap(readyHeap);
+    freeArrivalCursor(&arrivals);
+}
 
-    printf("\nAverage Turnaround Time: %.2f\n", *avgTurnaroundTime);
-    printf("Average Waiting Time: %.2f\n", *avgWaitingTime);
-    printf("Average Response Time: %.2f\n", *avgResponseTime);
-    printf("Throughput: %.2f processes/unit time\n", *throughput);
+// Shortest Job First with oracle knowledge of every burst's length
+void sjf(Process* processes, int numProcesses, const SimConfig* config, RunResult* result) {
+    runSjf(processes, numProcesses, config, result, NULL);
+}
 
-    // Free allocated memory
-    freeTimeline(t);
-    free(isCompleted);
+// Shortest Job First on burst lengths predicted by exponential averaging of past bursts
+void predictedSjf(Process* processes, int numProcesses, const SimConfig* config, RunResult* result) {
+    BurstPredictor* predictor = createBurstPredictor(numProcesses, config->predictionAlpha);
+    runSjf(processes, numProcesses, config, result, predictor);
+    freeBurstPredictor(predictor);
 }
@@ -5,133 +5,122 @@
 #include <time.h>
 #include "process_utils.h"
 #include "queue_utils.h"
+#include "event_utils.h"
+#include "predict_utils.h"
 #include "simulation.h"
 
-// This function returns the process in the ready queue with the shortest remaining time to complete execution
-Process* getSRTFProcess(Queue* q)
+// Remaining time a process is scheduled on: the true time left in its CPU burst, or with a predictor its estimate
+static long long srtfKey(Process processes[], int handle, BurstPredictor* predictor)
 {
-	Process* srtfProcess = NULL;
-	int srtfValue = INT_MAX;
-	for(int i = 0; i < q->size ; i++)
-	{
-		int idx = (q->front + i) % (q->capacity);
-		Process* curr = &q->processes[idx];
-		if(curr->remainingTime > 0 && curr->remainingTime < srtfValue)
-		{
-			srtfProcess = curr;
-			srtfValue = curr->remainingTime;
-		}
-	}
-	return srtfProcess;
+	return (predictor != NULL) ? predictedRemaining(predictor, handle) : processes[handle].remainingTime;
 }
 
-// This function dequeues the completed process without affecting the rest of the ready queue
-void removeFromQueue(Queue* q, Process* p)
-{
-	Queue* temp = createQueue(q->capacity);
-	while(!isQueueEmpty(q))
-	{
-		Process removed = dequeue(q);
-		if(removed.name != p->name)
-		{
-			enqueue(temp, removed);
-		}
-	}
-	while(!isQueueEmpty(temp))
-	{
-		enqueue(q,dequeue(temp));
-	}
-	freeQueue(temp);
-}
-
-// This function implements the Shortest Remaining Time First scheduling algorithm
-void srtf(Process processes[], int numProcesses, float* avgTurnaroundTime, float* avgWaitingTime, float* avgResponseTime, float* throughput)
+// This function implements the Shortest Remaining Time First scheduling algorithm, on true or predicted remaining times
+static void runSrtf(Process processes[], int numProcesses, const SimConfig* config, RunResult* result, BurstPredictor* predictor)
 {
 	int currTime = 0;
 	int completedProcesses = 0;
-	float totalTurnaroundTime = 0, totalWaitingTime = 0, totalResponseTime = 0;
     Timeline* t = createTimeline(100);
-    Queue* readyQueue = createQueue(numProcesses); // Creating a process queue for all the ready processes
-    printf("\nShortest Remaining Time First Scheduling:\n");
+    // Ready processes keyed on remaining time. Predicted keys are fixed point and may not fit the scan layout.
+    ReadyHeap* readyHeap = (predictor != NULL) ? createReadyHeap(numProcesses) : createShortestFirstHeap(config, numProcesses);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
 
     while(completedProcesses < numProcesses)
     {
-    	// Check the current time to ensure processes don't start at or beyond the 100th quantum
-    	if (currTime >= 100)
+    	// Check the current time to ensure processes don't start at or beyond the horizon
+    	if (currTime >= config->horizon)
     	{
-    		printf("Stopping simulation since a process cannot be executed at or beyond the 100th quantum.\n");
+    		result->stoppedAt = config->horizon;
     		break;
     	}
-    	// Enqueue the newly-arrived processes
-    	for (int i = 0; i < numProcesses; i++)
+    	// Enqueue the newly-arrived processes and those that finished their I/O
+    	int arrived;
+    	while((arrived = nextArrival(&arrivals, currTime)) != -1)
     	{
-    		if(processes[i].arrivalTime == currTime && processes[i].remainingTime > 0)
-    		{
-    			enqueue(readyQueue, processes[i]);
-    		}
-
+    		heapInsert(readyHeap, arrived, srtfKey(processes, arrived, predictor));
     	}
 
-    	//Invoke function to find process with the shortest remaining time
-    	Process* srtfProcess = getSRTFProcess(readyQueue);
+    	// The top of the heap is the process with the shortest remaining time
+    	int srtfIndex = heapPeek(readyHeap);
 
-    	if(srtfProcess == NULL)
+    	if(srtfIndex == -1)
     	{
-    		// In this case, no process is ready and the CPU is idle
-    		updateTimeline(t, currTime, 1, '-');
-            currTime += 1;
+    		// In this case, no process is ready and the CPU is idle until the next arrival
+    		currTime = skipIdleTime(&arrivals, t, currTime, config->horizon);
     	}
     	else
     	{
     		//SRTF process found - start executing it
+    		Process* srtfProcess = &processes[srtfIndex];
+    		result->decisions++;
+
+    		// The choice can only change when a new process arrives, so run until then (or until completion).
+    		// A context switch to the process delays the whole step.
+    		int runUntil = currTime + srtfProcess->remainingTime;
+    		int step = nextEventTime(&arrivals, currTime, runUntil < config->horizon ? runUntil : config->horizon) - currTime;
+    		currTime = switchContext(t, currTime, srtfProcess->pid, config->switchCost);
     		if(srtfProcess->startTime == -1)
     		{
     			srtfProcess->startTime = currTime; // Mark the process as started - this takes place just once
     		}
+    		updateTimeline(t, currTime, step, srtfProcess->pid);
+    		srtfProcess->remainingTime -= step;
+    		currTime += step;
+    		if(predictor != NULL)
+    		{
+    			chargeBurst(predictor, srtfIndex, step);
+    		}
 
-    		// Run the process for one quantum of time
-    		updateTimeline(t, currTime, 1, srtfProcess->name);
-    		srtfProcess->remainingTime -= 1;
-    		currTime += 1;
-
-    		// Check if the process is complete
+    		// Check if the CPU burst is over: the process is complete, or blocks until its I/O is done
     		if(srtfProcess->remainingTime == 0)
     		{
-    			completedProcesses += 1;
-    			srtfProcess->completionTime = currTime;
-
-    			// Calculate turnaround time, response time and waiting time
-    			int tat = srtfProcess->completionTime - srtfProcess->arrivalTime;
-    			int rt = srtfProcess->startTime - srtfProcess->arrivalTime;
-    			int wt = tat - srtfProcess->runtime;
-
-    			totalTurnaroundTime += tat;
-    			totalResponseTime += rt;
-    			totalWaitingTime += wt;
-
-    			// Print the individual metrics
-            	printf("Process %c: Arrival Time = %d, Runtime = %d, Turnaround Time = %d, Waiting Time = %d, Response Time = %d\n", srtfProcess->name, srtfProcess->arrivalTime, srtfProcess->runtime, tat, wt, rt);
-
-    			//Dequeue the completed process
-    			removeFromQueue(readyQueue, srtfProcess);
+    			//Dequeue the process either way
+    			heapRemove(readyHeap, srtfIndex);
+    			if(predictor != NULL)
+    			{
+    				endBurst(predictor, srtfIndex);
+    			}
+
+    			if(finishBurst(&arrivals, srtfIndex, currTime))
+    			{
+    				completedProcesses += 1;
+    				srtfProcess->completionTime = currTime;
+
+    				// Record turnaround time, response time and waiting time
+    				recordCompletion(result, srtfProcess);
+    			}
+    		}
+    		else
+    		{
+    			// Running only shortens its (predicted) remaining time, so it stays at the top of the heap
+    			heapDecreaseKey(readyHeap, srtfIndex, srtfKey(processes, srtfIndex, predictor));
     		}
     	}
     }
 
-    // Printing the timeline
-    printTimeline(t);
-
-    *avgTurnaroundTime = totalTurnaroundTime / completedProcesses;
-    *avgWaitingTime = totalWaitingTime / completedProcesses;
-    *avgResponseTime = totalResponseTime / completedProcesses;
-    *throughput = (float)completedProcesses / t->size;
-    // Printing the calculated averages for turnaround time, response time and waiting time
-    printf("\nAverage Turnaround Time: %.2f\n", *avgTurnaroundTime);
-    printf("\nAverage Waiting Time: %.2f\n", *avgWaitingTime);
-    printf("\nAverage Response Time: %.2f\n", *avgResponseTime);
-    printf("\nThroughput: %.2f processes/unit time\n", *throughput);
+    // Calculating the averages for turnaround time, response time and waiting time; the result takes over the timeline
+    if (predictor != NULL)
+    {
+        recordPredictions(result, predictor);
+    }
+    finishRunResult(result, t);
 
     // Finally, memory has to be freed
-    freeTimeline(t);
-    freeQueue(readyQueue);
+    freeReadyHeap(readyHeap);
+    freeArrivalCursor(&arrivals);
+}
+
+// Shortest Remaining Time First with oracle knowledge of every burst's remaining time
+void srtf(Process processes[], int numProcesses, const SimConfig* config, RunResult* result)
+{
+    runSrtf(processes, numProcesses, config, result, NULL);
+}
+
+// Shortest Remaining Time First on remaining times predicted by exponential averaging of past bursts
+void predictedSrtf(Process processes[], int numProcesses, const SimConfig* config, RunResult* result)
+{
+    BurstPredictor* predictor = createBurstPredictor(numProcesses, config->predictionAlpha);
+    runSrtf(processes, numProcesses, config, result, predictor);
+    freeBurstPredictor(predictor);
 }
@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <math.h>
+#include "stats_utils.h"
+
+// Two-sided 95% critical values of Student's t distribution for 1 to 30 degrees of freedom
+static const double tCritical95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+// Add a sample, updating the mean and the sum of squared differences in one pass
+void addSample(OnlineStats* stats, double sample) {
+    stats->count++;
+    double delta = sample - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (sample - stats->mean);
+}
+
+// Sample standard deviation, or 0 with fewer than two samples
+double sampleStddev(const OnlineStats* stats) {
+    return (stats->count > 1) ? sqrt(stats->m2 / (stats->count - 1)) : 0.0;
+}
+
+// Half width of the 95% confidence interval of the mean, from Student's t distribution. Beyond the
+// table, the Cornish-Fisher expansion of t around the normal value is accurate to 0.001.
+double confidenceHalfWidth(const OnlineStats* stats) {
+    if (stats->count < 2) {
+        return 0.0;
+    }
+    long long df = stats->count - 1;
+    double t;
+    if (df <= 30) {
+        t = tCritical95[df - 1];
+    } else {
+        double z = 1.959964;
+        double z3 = z * z * z;
+        t = z + (z3 + z) / (4.0 * df) + (5 * z3 * z * z + 16 * z3 + 3 * z) / (96.0 * df * df);
+    }
+    return t * sampleStddev(stats) / sqrt((double)stats->count);
+}
+
+// Print the mean of a metric, with its standard deviation and 95% confidence interval once there is
+// more than one sample
+void printStats(const OnlineStats* stats, const char* label, const char* unit) {
+    printf("%s: %.2f%s", label, stats->mean, unit);
+    if (stats->count > 1) {
+        printf(" (stddev %.2f, 95%% CI %.2f to %.2f)", sampleStddev(stats),
+               stats->mean - confidenceHalfWidth(stats), stats->mean + confidenceHalfWidth(stats));
+    }
+    printf("\n");
+}
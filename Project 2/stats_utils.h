@@ -0,0 +1,18 @@
+#ifndef STATS_UTILS_H
+#define STATS_UTILS_H
+
+// Running mean and variance of a stream of samples (Welford's algorithm), so any number of
+// trials can be summarized without keeping their samples
+typedef struct OnlineStats {
+    long long count; // Samples added
+    double mean;     // Mean of the samples
+    double m2;       // Sum of squared differences from the mean
+} OnlineStats;
+
+// Online statistics utilities
+void addSample(OnlineStats* stats, double sample);
+double sampleStddev(const OnlineStats* stats);
+double confidenceHalfWidth(const OnlineStats* stats);
+void printStats(const OnlineStats* stats, const char* label, const char* unit);
+
+#endif
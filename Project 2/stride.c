@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "process_utils.h"
+#include "queue_utils.h"
+#include "event_utils.h"
+#include "simulation.h"
+#include "arena_utils.h"
+
+// Stride of a priority level: the pass a process advances by per quantum it runs. More tickets
+// mean a shorter stride, so the process comes round again sooner.
+long long strideLength(int priority)
+{
+    return STRIDE1 / lotteryTickets(priority);
+}
+
+// Stride scheduling, the deterministic counterpart of lottery scheduling: the runnable process with the
+// smallest pass runs for a quantum and then advances its pass by its stride, so every process gets the
+// CPU in proportion to its tickets to within a quantum. Passes are kept in a ready heap, and a new process
+// starts one stride past the smallest pass so it cannot claim the time that went by before it arrived.
+void stride(Process processes[], int numProcesses, const SimConfig* config, RunResult* result)
+{
+    ReadyHeap* ready = createReadyHeap(numProcesses);
+    long long* pass = (long long*)runCalloc(numProcesses, sizeof(long long));
+    if (pass == NULL)
+    {
+        fprintf(stderr, "Error allocating stride state!\n");
+        exit(EXIT_FAILURE);
+    }
+    Timeline* t = createTimeline(100);
+    ArrivalCursor arrivals;
+    initArrivalCursor(&arrivals, processes, numProcesses, config->trace);
+
+    long long levelTickets[NUM_PRIORITIES] = {0}; // Tickets held by the runnable processes of each priority level
+    long long minPass = 0;                        // Never decreases; follows the smallest runnable pass
+    int currentTime = 0, completed = 0;
+    result->reportByPriority = 1;
+    result->reportShares = 1;
+
+    while (completed < numProcesses)
+    {
+        // Check the current time to ensure processes don't start at or beyond the horizon
+        if (currentTime >= config->horizon)
+        {
+            result->stoppedAt = config->horizon;
+            break;
+        }
+
+        // New processes, and those that finished their I/O, start one stride past the smallest pass
+        int arrived;
+        while ((arrived = nextArrival(&arrivals, currentTime)) != -1)
+        {
+            pass[arrived] = minPass + strideLength(processes[arrived].priority);
+            levelTickets[processes[arrived].priority - 1] += lotteryTickets(processes[arrived].priority);
+            heapInsert(ready, arrived, pass[arrived]);
+        }
+
+        if (isHeapEmpty(ready))
+        {
+            // CPU is idle until the next arrival
+            currentTime = skipIdleTime(&arrivals, t, currentTime, config->horizon);
+            continue;
+        }
+
+        int handle = heapPop(ready);
+        Process* process = &processes[handle];
+        result->decisions++;
+        // Run it for one quantum, or less if it finishes first. A process that is alone would be picked
+        // again after every quantum, so it keeps the CPU until it finishes or the quantum in which the
+        // next process arrives is over. A context switch to it delays the slice.
+        int runUntil = currentTime + process->remainingTime;
+        if (runUntil > config->horizon)
+        {
+            runUntil = config->horizon;
+        }
+        int slice = config->quantum;
+        if (isHeapEmpty(ready))
+        {
+            slice = nextEventTime(&arrivals, currentTime, runUntil) - currentTime;
+            slice = (slice + config->quantum - 1) / config->quantum * config->quantum;
+        }
+        if (slice > runUntil - currentTime)
+        {
+            slice = runUntil - currentTime;
+        }
+        currentTime = switchContext(t, currentTime, process->pid, config->switchCost);
+        if (process->startTime == -1)
+        {
+            process->startTime = currentTime;
+        }
+        updateTimeline(t, currentTime, slice, process->pid);
+        result->cpuTime[process->priority - 1] += slice;
+        recordShares(result, levelTickets, slice);
+        process->remainingTime -= slice;
+        pass[handle] += strideLength(process->priority) * slice;
+        currentTime += slice;
+
+        if (process->remainingTime == 0)
+        {
+            // Finished, or blocked until its I/O is done
+            levelTickets[process->priority - 1] -= lotteryTickets(process->priority);
+            if (finishBurst(&arrivals, handle, currentTime))
+            {
+                process->completionTime = currentTime;
+                recordCompletion(result, process);
+                completed++;
+            }
+        }
+        else
+        {
+            heapInsert(ready, handle, pass[handle]);
+        }
+        if (!isHeapEmpty(ready) && pass[heapPeek(ready)] > minPass)
+        {
+            minPass = pass[heapPeek(ready)];
+        }
+    }
+
+    // Calculate averages for this run; the result takes over the timeline
+    finishRunResult(result, t);
+
+    // Free allocated resources
+    freeReadyHeap(ready);
+    runFree(pass);
+    freeArrivalCursor(&arrivals);
+}
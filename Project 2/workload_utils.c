@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "workload_utils.h"
+
+// Print where in a trace the process being read comes from, ahead of an error about it
+static void printTraceLocation(WorkloadReader* reader) {
+    if (reader->file != NULL) {
+        fprintf(stderr, "%s:%d: ", reader->path, reader->line);
+    } else {
+        fprintf(stderr, "%s: record %u: ", reader->path, reader->next);
+    }
+}
+
+// Validate a process read from a trace and fill in the fields the schedulers start from. Every process
+// must be able to finish before TRACE_TIME_LIMIT, even after waiting for all the work read before it,
+// so no completion or turnaround time can overflow.
+static void initTraceProcess(WorkloadReader* reader, Process* process, long arrivalTime, long runtime, long priority, long deadline) {
+    if (arrivalTime < 0 || runtime < 1 || arrivalTime > TRACE_TIME_LIMIT - runtime || priority < 1 || priority > 4 ||
+        deadline <= arrivalTime || deadline > NO_DEADLINE) {
+        printTraceLocation(reader);
+        fprintf(stderr, "invalid process (arrival %ld, runtime %ld, priority %ld, deadline %ld)\n", arrivalTime, runtime, priority, deadline);
+        exit(EXIT_FAILURE);
+    }
+    // Schedulers admit processes in file order, so a trace out of arrival order is rejected rather than sorted
+    if (arrivalTime < reader->lastArrival) {
+        printTraceLocation(reader);
+        fprintf(stderr, "process arrives at %ld, before the one ahead of it at %d; traces must be sorted by arrival time\n",
+                arrivalTime, reader->lastArrival);
+        exit(EXIT_FAILURE);
+    }
+    reader->lastArrival = (int)arrivalTime;
+    reader->busyUntil = ((arrivalTime > reader->busyUntil) ? arrivalTime : reader->busyUntil) + runtime;
+    if (reader->busyUntil > TRACE_TIME_LIMIT) {
+        printTraceLocation(reader);
+        fprintf(stderr, "the processes up to here need the CPU until quantum %lld, past the limit of %d\n", reader->busyUntil, TRACE_TIME_LIMIT);
+        exit(EXIT_FAILURE);
+    }
+    process->pid = reader->nextPid++;
+    process->arrivalTime = (int)arrivalTime;
+    process->runtime = (int)runtime;
+    process->priority = (int)priority;
+    process->deadline = (int)deadline;
+    process->startTime = -1;
+    process->completionTime = 0;
+    process->remainingTime = process->runtime;
+    process->cpuBursts = 1; // Traces carry no I/O bursts
+    process->ioLength = 0;
+    process->burst = 0;
+}
+
+// Map a binary trace and check that its size matches the record count in the header
+static void mapBinaryTrace(WorkloadReader* reader) {
+    int fd = open(reader->path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        perror("Failed to open binary trace");
+        exit(EXIT_FAILURE);
+    }
+    reader->mapSize = (size_t)info.st_size;
+    reader->map = mmap(NULL, reader->mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (reader->map == MAP_FAILED) {
+        perror("Failed to map binary trace");
+        exit(EXIT_FAILURE);
+    }
+    madvise(reader->map, reader->mapSize, MADV_SEQUENTIAL);
+    if (reader->mapSize < sizeof(TraceHeader)) {
+        fprintf(stderr, "%s: binary trace has no complete header\n", reader->path);
+        exit(EXIT_FAILURE);
+    }
+
+    const TraceHeader* header = (const TraceHeader*)reader->map;
+    reader->count = header->count;
+    reader->records = (const char*)(header + 1);
+    if (reader->mapSize != sizeof(TraceHeader) + (size_t)reader->count * reader->recordSize) {
+        fprintf(stderr, "%s: binary trace is truncated or corrupt (%u records in %zu bytes)\n",
+                reader->path, reader->count, reader->mapSize);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Open a trace. Binary traces are recognized by their magic number; anything else is read as
+// text with one "arrival runtime priority [deadline]" line per process ('#' starts a comment).
+WorkloadReader* openWorkload(const char* path) {
+    WorkloadReader* reader = (WorkloadReader*)calloc(1, sizeof(WorkloadReader));
+    if (reader == NULL) {
+        fprintf(stderr, "Error allocating workload reader!\n");
+        exit(EXIT_FAILURE);
+    }
+    reader->path = path;
+    reader->nextPid = 1;
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        perror("Failed to open trace");
+        exit(EXIT_FAILURE);
+    }
+    char magic[sizeof(TRACE_MAGIC) - 1];
+    int complete = fread(magic, 1, sizeof(magic), file) == sizeof(magic);
+    if (complete && memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0) {
+        reader->recordSize = sizeof(TraceRecord);
+    } else if (complete && memcmp(magic, TRACE_MAGIC_V1, sizeof(magic)) == 0) {
+        reader->recordSize = TRACE_RECORD_SIZE_V1;
+    }
+    if (reader->recordSize != 0) {
+        fclose(file);
+        mapBinaryTrace(reader);
+        return reader;
+    }
+
+    rewind(file);
+    reader->file = file;
+    reader->buffer = (char*)malloc(TRACE_BUFFER_SIZE);
+    if (reader->buffer == NULL || setvbuf(file, reader->buffer, _IOFBF, TRACE_BUFFER_SIZE) != 0) {
+        fprintf(stderr, "Error setting up the trace buffer!\n");
+        exit(EXIT_FAILURE);
+    }
+    return reader;
+}
+
+// Read the next process of a trace. Returns 1 if a process was read and 0 at the end of the trace.
+int readNextProcess(WorkloadReader* reader, Process* process) {
+    if (reader->file == NULL) {
+        if (reader->next >= reader->count) {
+            return 0;
+        }
+        const TraceRecord* record = (const TraceRecord*)(reader->records + (size_t)reader->next * reader->recordSize);
+        long deadline = (reader->recordSize == sizeof(TraceRecord)) ? record->deadline : NO_DEADLINE;
+        initTraceProcess(reader, process, record->arrivalTime, record->runtime, record->priority, deadline);
+        reader->next++;
+        return 1;
+    }
+
+    char line[TRACE_LINE_LENGTH];
+    while (fgets(line, sizeof(line), reader->file) != NULL) {
+        reader->line++;
+        if (strchr(line, '\n') == NULL && !feof(reader->file)) {
+            fprintf(stderr, "%s:%d: line is longer than %d characters\n", reader->path, reader->line, TRACE_LINE_LENGTH - 2);
+            exit(EXIT_FAILURE);
+        }
+        char* comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+
+        // Parse up to four integers; blank lines are skipped
+        long values[4];
+        int parsed = 0;
+        char* cursor = line;
+        for (;;) {
+            while (isspace((unsigned char)*cursor)) {
+                cursor++;
+            }
+            if (*cursor == '\0') {
+                break;
+            }
+            char* end;
+            errno = 0;
+            long value = strtol(cursor, &end, 10);
+            if (end == cursor || errno != 0 || parsed == 4) {
+                parsed = -1;
+                break;
+            }
+            values[parsed++] = value;
+            cursor = end;
+        }
+        if (parsed == 0) {
+            continue;
+        }
+        if (parsed < 3) {
+            fprintf(stderr, "%s:%d: expected \"arrival runtime priority [deadline]\"\n", reader->path, reader->line);
+            exit(EXIT_FAILURE);
+        }
+        initTraceProcess(reader, process, values[0], values[1], values[2], (parsed == 4) ? values[3] : NO_DEADLINE);
+        return 1;
+    }
+    if (ferror(reader->file)) {
+        perror("Failed to read trace");
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
+
+// Close a trace and release its buffer or mapping
+void closeWorkload(WorkloadReader* reader) {
+    if (reader->file != NULL) {
+        fclose(reader->file);
+        free(reader->buffer);
+    } else {
+        munmap(reader->map, reader->mapSize);
+    }
+    free(reader);
+}
+
+// Count the processes of a trace, so each run can size its per-process state before streaming it.
+// A binary trace's header gives the count; a text trace is read through once.
+int countWorkload(const char* path) {
+    WorkloadReader* reader = openWorkload(path);
+    long long count = 0;
+    if (reader->file == NULL) {
+        count = reader->count;
+    } else {
+        Process process;
+        while (readNextProcess(reader, &process)) {
+            count++;
+        }
+    }
+    closeWorkload(reader);
+    if (count == 0) {
+        fprintf(stderr, "%s: trace contains no processes\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (count > INT32_MAX) {
+        fprintf(stderr, "%s: too many records\n", path);
+        exit(EXIT_FAILURE);
+    }
+    return (int)count;
+}
+
+// Create a binary trace and write its header; the record count is filled in once the records are written
+static FILE* createBinaryTrace(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        perror("Failed to create binary trace");
+        exit(EXIT_FAILURE);
+    }
+    TraceHeader header;
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.count = 0;
+    header.reserved = 0;
+    fwrite(&header, sizeof(header), 1, file);
+    return file;
+}
+
+// Append a process to a binary trace
+static void writeTraceRecord(FILE* file, const Process* process) {
+    TraceRecord record;
+    record.arrivalTime = process->arrivalTime;
+    record.runtime = process->runtime;
+    record.priority = process->priority;
+    record.deadline = process->deadline;
+    fwrite(&record, sizeof(record), 1, file);
+}
+
+// Fill in the record count of a binary trace and close it
+static void finishBinaryTrace(FILE* file, uint32_t count) {
+    if (fseek(file, offsetof(TraceHeader, count), SEEK_SET) != 0 || fwrite(&count, sizeof(count), 1, file) != 1 ||
+        fclose(file) != 0) {
+        perror("Failed to write binary trace");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Write a workload as a binary trace that can be replayed through the memory-mapped fast path
+void saveBinaryTrace(const char* path, const Process* processes, int numProcesses) {
+    FILE* file = createBinaryTrace(path);
+    // Records are written in array (arrival) order, so a replay schedules exactly the same way;
+    // processes are numbered in that order when the trace is read back
+    for (int i = 0; i < numProcesses; i++) {
+        writeTraceRecord(file, &processes[i]);
+    }
+    finishBinaryTrace(file, (uint32_t)numProcesses);
+}
+
+// Convert a text (or binary) trace to a binary trace one process at a time. The trace is read while the
+// binary trace is written, so writing over the trace itself is refused rather than truncating it first.
+void convertTrace(const char* tracePath, const char* path) {
+    struct stat input, output;
+    if (stat(tracePath, &input) == 0 && stat(path, &output) == 0 && input.st_dev == output.st_dev && input.st_ino == output.st_ino) {
+        fprintf(stderr, "%s: cannot write a trace over the trace being read\n", path);
+        exit(EXIT_FAILURE);
+    }
+    WorkloadReader* reader = openWorkload(tracePath);
+    FILE* file = createBinaryTrace(path);
+    uint32_t count = 0;
+    Process process;
+    while (readNextProcess(reader, &process)) {
+        writeTraceRecord(file, &process);
+        count++;
+    }
+    closeWorkload(reader);
+    finishBinaryTrace(file, count);
+}
+
+static char* replayPath = NULL; // Temporary binary trace made by prepareReplayTrace(), removed at exit
+
+static void removeReplayTrace(void) {
+    unlink(replayPath);
+    free(replayPath);
+}
+
+// Return the trace the runs should replay. A binary trace is mapped as it is; a text trace is converted
+// once to a temporary binary trace (removed when the program exits), so every run maps it instead of
+// parsing the text again.
+const char* prepareReplayTrace(const char* path) {
+    WorkloadReader* reader = openWorkload(path);
+    int binary = (reader->file == NULL);
+    closeWorkload(reader);
+    if (binary) {
+        return path;
+    }
+
+    const char* dir = getenv("TMPDIR");
+    if (dir == NULL || *dir == '\0') {
+        dir = "/tmp";
+    }
+    size_t length = strlen(dir) + sizeof("/p2trace-XXXXXX");
+    replayPath = (char*)malloc(length);
+    if (replayPath == NULL) {
+        fprintf(stderr, "Error allocating the replay trace path!\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(replayPath, length, "%s/p2trace-XXXXXX", dir);
+    int fd = mkstemp(replayPath);
+    if (fd < 0) {
+        perror("Failed to create the replay trace");
+        exit(EXIT_FAILURE);
+    }
+    close(fd);
+    atexit(removeReplayTrace);
+    convertTrace(path, replayPath);
+    return replayPath;
+}
@@ -0,0 +1,62 @@
+#ifndef WORKLOAD_UTILS_H
+#define WORKLOAD_UTILS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "process_utils.h"
+
+#define TRACE_MAGIC "P2TRACE2"    // First 8 bytes of a binary trace
+#define TRACE_MAGIC_V1 "P2TRACE1" // First 8 bytes of a binary trace written before deadlines, still readable
+#define TRACE_LINE_LENGTH 256      // Longest line accepted in a text trace
+#define TRACE_BUFFER_SIZE (1 << 20) // stdio buffer used when streaming a text trace
+#define TRACE_TIME_LIMIT (INT32_MAX / 2) // Quantum by which a trace must be able to run every process; the rest
+                                         // of the int range is headroom for context switches and MLFQ boosts
+
+// Binary trace layout: a header followed by count fixed-size records in file order
+typedef struct TraceHeader {
+    char magic[8];     // TRACE_MAGIC
+    uint32_t count;    // Number of records
+    uint32_t reserved; // Always 0
+} TraceHeader;
+
+typedef struct TraceRecord {
+    int32_t arrivalTime;
+    int32_t runtime;
+    int32_t priority;
+    int32_t deadline;  // NO_DEADLINE if the process has none
+} TraceRecord;
+
+#define TRACE_RECORD_SIZE_V1 (3 * sizeof(int32_t)) // Version 1 records end before the deadline
+
+// Reads a trace one process at a time, in arrival order. Text traces are streamed through a fixed-size
+// buffer; binary traces are memory-mapped and decoded in place, so neither is ever read into memory whole.
+typedef struct WorkloadReader {
+    const char* path;            // Trace file, for error messages
+    int nextPid;                 // pid given to the next process (processes are numbered in file order)
+    int lastArrival;             // Arrival time of the last process read
+    long long busyUntil;         // Time one CPU would take to run every process read so far back to back
+    // Text traces
+    FILE* file;                  // Open trace, or NULL for a binary trace
+    char* buffer;                // stdio buffer of TRACE_BUFFER_SIZE bytes
+    int line;                    // Line number of the last line read
+    // Binary traces
+    const char* records;         // Mapped records
+    size_t recordSize;           // sizeof(TraceRecord), or TRACE_RECORD_SIZE_V1 for a version 1 trace
+    uint32_t count;              // Number of mapped records
+    uint32_t next;               // Index of the next record
+    void* map;                   // Whole mapping (header included)
+    size_t mapSize;              // Length of the mapping
+} WorkloadReader;
+
+// Workload reader utilities
+WorkloadReader* openWorkload(const char* path);
+int readNextProcess(WorkloadReader* reader, Process* process);
+void closeWorkload(WorkloadReader* reader);
+
+// Whole-workload helpers
+int countWorkload(const char* path);
+void saveBinaryTrace(const char* path, const Process* processes, int numProcesses);
+void convertTrace(const char* tracePath, const char* path);
+const char* prepareReplayTrace(const char* path);
+
+#endif
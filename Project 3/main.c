@@ -5,6 +5,7 @@
 #include <unistd.h>
 #include <time.h>
 #include "queue_utils.h"
+#include "rng_utils.h"
 
 /* Global variables for simulation */
 
@@ -56,6 +57,7 @@ typedef struct
 	int next_arrival_index; // Index to track arrival times array
 	int *arrival_times;		// Array (size=num_customers) of random arrival times (0-59)
 	int customer_count;		// To generate customer IDs sequentially
+	Rng rng;				// Seller's own random stream (arrival times and service durations)
 	// Metrics:
 	int served;				   // Number of customers served (ticket sold)
 	int turned_away;		   // Number of customers turned away (sold out or simulation end)
@@ -176,7 +178,7 @@ void generate_arrival_times(Seller *seller)
 	}
 	for (int i = 0; i < seller->num_customers; i++)
 	{
-		seller->arrival_times[i] = rand() % 60;
+		seller->arrival_times[i] = rngRange(&seller->rng, 60);
 	}
 	// Sort the arrival times
 	qsort(seller->arrival_times, seller->num_customers, sizeof(seller->arrival_times[0]), compare);
@@ -359,11 +361,11 @@ void *seller_thread(void *arg)
 				seller->total_response_time += response;
 				int service_duration = 0;
 				if (seller->type == 'H')
-					service_duration = (rand() % 2) + 1; // 1 or 2 minutes
+					service_duration = rngRange(&seller->rng, 2) + 1; // 1 or 2 minutes
 				else if (seller->type == 'M')
-					service_duration = (rand() % 3) + 2; // 2, 3, or 4 minutes
+					service_duration = rngRange(&seller->rng, 3) + 2; // 2, 3, or 4 minutes
 				else if (seller->type == 'L')
-					service_duration = (rand() % 4) + 4; // 4, 5, 6, or 7 minutes
+					service_duration = rngRange(&seller->rng, 4) + 4; // 4, 5, 6, or 7 minutes
 
 				cust->service_duration = service_duration;
 				service_end_time = local_time + service_duration;
@@ -386,20 +388,20 @@ void *seller_thread(void *arg)
 /* Main function */
 int main(int argc, char *argv[])
 {
-	if (argc != 2)
+	if (argc != 2 && !(argc == 4 && strcmp(argv[2], "--seed") == 0))
 	{
-		fprintf(stderr, "Usage: %s <number_of_customers_per_seller>\n", argv[0]);
+		fprintf(stderr, "Usage: %s <number_of_customers_per_seller> [--seed <seed>]\n", argv[0]);
 		exit(EXIT_FAILURE);
 	}
 	int N = atoi(argv[1]); // The number of customers per ticket seller
+	// Each seller draws from its own stream of this seed, so a run is reproducible regardless of thread interleaving
+	uint64_t seed = (argc == 4) ? strtoull(argv[3], NULL, 10) : 0;
 	if (N <= 0)
 	{
 		fprintf(stderr, "Number of customers must be a positive integer.\n");
 		exit(EXIT_FAILURE);
 	}
 
-	srand(0); // Seed the random number generator
-
 	// Initialize the seating chart and the orderings
 	initialize_seating_chart();
 	initialize_orderings();
@@ -416,6 +418,7 @@ int main(int argc, char *argv[])
 	sellers[t].queue = initQueue();
 	sellers[t].next_arrival_index = 0;
 	sellers[t].customer_count = 0;
+	rngStream(&sellers[t].rng, seed, t);
 	sellers[t].served = sellers[t].turned_away = 0;
 	sellers[t].total_response_time = sellers[t].total_turnaround_time = 0;
 	generate_arrival_times(&sellers[t]);
@@ -431,6 +434,7 @@ int main(int argc, char *argv[])
 		sellers[t].queue = initQueue();
 		sellers[t].next_arrival_index = 0;
 		sellers[t].customer_count = 0;
+		rngStream(&sellers[t].rng, seed, t);
 		sellers[t].served = sellers[t].turned_away = 0;
 		sellers[t].total_response_time = sellers[t].total_turnaround_time = 0;
 		generate_arrival_times(&sellers[t]);
@@ -447,6 +451,7 @@ int main(int argc, char *argv[])
 		sellers[t].queue = initQueue();
 		sellers[t].next_arrival_index = 0;
 		sellers[t].customer_count = 0;
+		rngStream(&sellers[t].rng, seed, t);
 		sellers[t].served = sellers[t].turned_away = 0;
 		sellers[t].total_response_time = sellers[t].total_turnaround_time = 0;
 		generate_arrival_times(&sellers[t]);
@@ -5,6 +5,9 @@
 #include <time.h>
 #include "helper.h"
 
+// Random streams used per run: one for the workload and one for each page replacement algorithm
+#define STREAMS_PER_RUN 6
+
 void copyProcesses(Process *dest, Process *source, int numProcesses)
 {
     for (int i = 0; i < numProcesses; i++)
@@ -19,9 +22,18 @@ void copyProcesses(Process *dest, Process *source, int numProcesses)
 
 int main(int argc, char *argv[])
 {
-    (void)argc;
-    (void)argv;
-    srand(time(NULL));
+    // --seed <seed> makes a run reproducible; by default the current time is used
+    uint64_t seed = (uint64_t)time(NULL);
+    if (argc == 3 && strcmp(argv[1], "--seed") == 0)
+    {
+        seed = strtoull(argv[2], NULL, 10);
+    }
+    else if (argc != 1)
+    {
+        fprintf(stderr, "Usage: %s [--seed <seed>]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    printf("Seed: %llu\n", (unsigned long long)seed);
 
     int runs = 5;
 
@@ -52,11 +64,14 @@ int main(int argc, char *argv[])
 
         // Generate a set of processes
         Process *processes = (Process *)malloc(TOTAL_PROCESSES * sizeof(Process));
-        generateProcesses(processes, TOTAL_PROCESSES);
+        Rng rng;
+        rngStream(&rng, seed, i * STREAMS_PER_RUN);
+        generateProcesses(processes, TOTAL_PROCESSES, &rng);
 
         // ---------------- FIFO Simulation ----------------
         Process *fifoProcesses = (Process *)malloc(TOTAL_PROCESSES * sizeof(Process));
         copyProcesses(fifoProcesses, processes, TOTAL_PROCESSES);
+        seedThreadRng(seed, i * STREAMS_PER_RUN + 1);
         PageList *fifo_plist = (PageList *)malloc(sizeof(PageList));
         initPageList(fifo_plist);
         int fifo_run_swaps = 0;
@@ -72,6 +87,7 @@ int main(int argc, char *argv[])
         // ---------------- LRU Simulation ----------------
         Process *lruProcesses = (Process *)malloc(TOTAL_PROCESSES * sizeof(Process));
         copyProcesses(lruProcesses, processes, TOTAL_PROCESSES);
+        seedThreadRng(seed, i * STREAMS_PER_RUN + 2);
         PageList *lru_plist = (PageList *)malloc(sizeof(PageList));
         initPageList(lru_plist);
         int lru_run_swaps = 0;
@@ -87,6 +103,7 @@ int main(int argc, char *argv[])
         // ---------------- LFU Simulation ----------------
         Process *lfuProcesses = (Process *)malloc(TOTAL_PROCESSES * sizeof(Process));
         copyProcesses(lfuProcesses, processes, TOTAL_PROCESSES);
+        seedThreadRng(seed, i * STREAMS_PER_RUN + 3);
         PageList *lfu_plist = (PageList *)malloc(sizeof(PageList));
         initPageList(lfu_plist);
         int lfu_run_swaps = 0;
@@ -102,6 +119,7 @@ int main(int argc, char *argv[])
         // ---------------- Random Pick Simulation ----------------
         Process *rpProcesses = (Process *)malloc(TOTAL_PROCESSES * sizeof(Process));
         copyProcesses(rpProcesses, processes, TOTAL_PROCESSES);
+        seedThreadRng(seed, i * STREAMS_PER_RUN + 4);
         PageList *rp_plist = (PageList *)malloc(sizeof(PageList));
         initPageList(rp_plist);
         int rp_run_swaps = 0;
@@ -117,6 +135,7 @@ int main(int argc, char *argv[])
         // ---------------- MFU Simulation ----------------
         Process *mfuProcesses = (Process *)malloc(TOTAL_PROCESSES * sizeof(Process));
         copyProcesses(mfuProcesses, processes, TOTAL_PROCESSES);
+        seedThreadRng(seed, i * STREAMS_PER_RUN + 5);
         PageList *mfu_plist = (PageList *)malloc(sizeof(PageList));
         initPageList(mfu_plist);
         int mfu_run_swaps = 0;
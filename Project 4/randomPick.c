@@ -43,7 +43,7 @@ void randomPick(PageList *plist)
     }
     
     // 3) Pick a random index in [0, inUseCount-1]
-    int r = rand() % inUseCount;
+    int r = rngRange(threadRng(), inUseCount);
     Page* victim = inUsePages[r];
     
     printf("[DEBUG] Random Pick evicting Page %d from Process %d.\n",
@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "rng_utils.h"
+
+// Thread-local generator used by threadRng(); seeded with seed 0, stream 0 on first use
+static _Thread_local Rng threadState;
+static _Thread_local int threadSeeded = 0;
+
+// splitmix64: expands one 64-bit value into well-mixed generator state
+static uint64_t splitmix64(uint64_t* x) {
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+// Seed a generator from a single 64-bit value
+void rngSeed(Rng* rng, uint64_t seed) {
+	uint64_t x = seed;
+	for (int i = 0; i < 4; i++) {
+		rng->s[i] = splitmix64(&x);
+	}
+}
+
+// Seed the generator of one stream (a trial, a thread, a seller, ...) of a seeded experiment.
+// Different streams of the same seed give unrelated sequences.
+void rngStream(Rng* rng, uint64_t seed, uint64_t stream) {
+	uint64_t x = stream;
+	rngSeed(rng, seed ^ splitmix64(&x));
+}
+
+// Return the next 64 random bits
+uint64_t rngNext(Rng* rng) {
+	uint64_t* s = rng->s;
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return result;
+}
+
+// Return a uniformly distributed integer in [0, n) without modulo bias (Lemire's method)
+int rngRange(Rng* rng, int n) {
+	if (n <= 0) {
+		fprintf(stderr, "Invalid random range %d!\n", n);
+		exit(EXIT_FAILURE);
+	}
+	uint32_t bound = (uint32_t)n;
+	uint64_t m = (rngNext(rng) >> 32) * bound;
+	uint32_t low = (uint32_t)m;
+	if (low < bound) {
+		uint32_t threshold = -bound % bound;
+		while (low < threshold) {
+			m = (rngNext(rng) >> 32) * bound;
+			low = (uint32_t)m;
+		}
+	}
+	return (int)(m >> 32);
+}
+
+// Return the calling thread's generator
+Rng* threadRng(void) {
+	if (!threadSeeded) {
+		rngStream(&threadState, 0, 0);
+		threadSeeded = 1;
+	}
+	return &threadState;
+}
+
+// Reseed the calling thread's generator, e.g. at the start of each run
+void seedThreadRng(uint64_t seed, uint64_t stream) {
+	rngStream(&threadState, seed, stream);
+	threadSeeded = 1;
+}
@@ -0,0 +1,24 @@
+#ifndef RNG_UTILS_H
+#define RNG_UTILS_H
+
+#include <stdint.h>
+
+// xoshiro256** generator state. Every run or thread owns its own state, so draws never
+// contend on a shared generator and a given (seed, stream) always yields the same sequence.
+typedef struct Rng {
+	uint64_t s[4];
+} Rng;
+
+// Seeding
+void rngSeed(Rng* rng, uint64_t seed);
+void rngStream(Rng* rng, uint64_t seed, uint64_t stream);
+
+// Drawing numbers
+uint64_t rngNext(Rng* rng);
+int rngRange(Rng* rng, int n);
+
+// Per-thread generator for code that has no natural place to carry an Rng
+Rng* threadRng(void);
+void seedThreadRng(uint64_t seed, uint64_t stream);
+
+#endif
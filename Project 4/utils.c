@@ -8,16 +8,16 @@
 
 int page_counts[4] = {5, 11, 17, 31};
 
-// Generate random processes
-void generateProcesses(Process *processes, int numProcesses)
+// Generate random processes from the caller's generator
+void generateProcesses(Process *processes, int numProcesses, Rng *rng)
 {
 	printf("Starting generation.\n");
 	for (int i = 0; i < numProcesses; i++)
 	{
 		processes[i].id = i + 1;
-		processes[i].num_pages = page_counts[rand() % 4];
-		processes[i].arrival_time = rand() % 60;	  // Random arrival time (0–59)
-		processes[i].service_time = (rand() % 5) + 1; // Random runtime (1–5)
+		processes[i].num_pages = page_counts[rngRange(rng, 4)];
+		processes[i].arrival_time = rngRange(rng, 60);	  // Random arrival time (0–59)
+		processes[i].service_time = rngRange(rng, 5) + 1; // Random runtime (1–5)
 		processes[i].starting_page_num = 0;
 		if (processes[i].service_time <= 0)
 		{
@@ -317,20 +317,21 @@ int ifExistsInMemory(PageList *plist, int pid, int pg_num)
 	return 0;
 }
 
-// Return the next page for the requesting process
+// Return the next page for the requesting process, drawing from the calling thread's generator
 int getNextPage(int curr_page_num, int max_page_size)
 {
-	int next_page = rand() % 10;
+	Rng *rng = threadRng();
+	int next_page = rngRange(rng, 10);
 	if (next_page < 7)
 	{
-		next_page = curr_page_num + (rand() % 3) - 1;
+		next_page = curr_page_num + rngRange(rng, 3) - 1;
 	}
 	else
 	{
-		next_page = rand() % max_page_size;
+		next_page = rngRange(rng, max_page_size);
 		while (abs(next_page - curr_page_num) <= 1)
 		{
-			next_page = rand() % max_page_size;
+			next_page = rngRange(rng, max_page_size);
 		}
 	}
 	if (next_page < 0)
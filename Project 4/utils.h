@@ -7,6 +7,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
+#include "rng_utils.h"
 
 #define TOTAL_PROCESSES 150
 #define TOTAL_PAGE_REFS 100
@@ -64,5 +65,5 @@ int ifExistsInQueue(Queue* queue, int pid);
 void removeFromQueue(Queue *q, Process *p);
 
 // Process generation function
-void generateProcesses(Process* processes, int numProcesses);
+void generateProcesses(Process* processes, int numProcesses, Rng* rng);
 int compareByArrivalTime(const void* a, const void* b);